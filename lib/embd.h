@@ -42,17 +42,17 @@
 // 
 // Select the platform under use, here (which is always AVR)
 // 
-// For PC:		Set emdb_Platform to embd_PlatformPC
+// For PC:		Set embd_Platform to embd_PlatformPC
 // For AVR:		Set embd_Platform to embd_PlatformAVR
 //
-#define	emdb_PlatformPC			1
+#define	embd_PlatformPC			1
 #define	embd_PlatformAVR		2
-#define	emdb_Platform			embd_PlatformPC
+#define	embd_Platform			embd_PlatformPC
 
 
 
 // Requisite headers
-#if emdb_Platform == embd_PlatformAVR
+#if embd_Platform == embd_PlatformAVR
 #include <Arduino.h>
 #endif
 
@@ -82,6 +82,56 @@
 
 
 
+// Index width options
+// 
+// 8 -	Lists and streams hold upto 256 pairs / bytes (smallest footprint, for AVR)
+// 16 -	Lists and streams hold upto 65536 pairs / bytes
+// 32 -	Lists and streams hold upto 2^32 pairs / bytes (for PC)
+#define	emList_IndexWidth		8
+#define	emStream_IndexWidth		8
+
+
+
+// Task removal order
+// 
+// 0 -	Removing a task preserves the round-robin order of remaining tasks
+// 1 -	Removing a task moves the last task into its place (constant time)
+#define	emTask_UnorderedRemove	0
+
+
+
+// Task scheduling options
+//
+// emTask_Priorities -	Number of task priority levels (1 to 8)
+// emTask_EDF -			0: ready tasks of a level run in FIFO order
+//						1: ready tasks of a level run in order of Deadline (earliest first)
+// emTask_Latency -		0: no instrumentation
+//						1: worst-case dispatch latency of each level is recorded
+#define	emTask_Priorities		8
+#define	emTask_EDF				0
+#define	emTask_Latency			0
+
+
+
+// Timer wheel options
+//
+// emTask_WheelLevels -	0: no timer wheel, a sleeping task checks its deadline each time it is run
+//						1 or more: sleeping tasks wait in a timer wheel of that many levels
+// emTask_WheelBits -	each level of the wheel has 2^WheelBits slots (of 1 ms at level 0)
+//
+// The wheel takes (WheelLevels + 1) * 2^WheelBits events of RAM: 7 bytes each on AVR
+// (448 bytes for 3 levels of 4 bits), and 32 bytes each on PC (10 KB for 4 levels
+// of 6 bits).
+#if embd_Platform == embd_PlatformPC
+#define	emTask_WheelLevels		4
+#define	emTask_WheelBits		6
+#else
+#define	emTask_WheelLevels		0
+#define	emTask_WheelBits		4
+#endif
+
+
+
 // Include Library headers
 #include "embd/emType.h"
 #include "embd/emList.h"
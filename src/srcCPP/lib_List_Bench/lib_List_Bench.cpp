@@ -0,0 +1,131 @@
+/*
+----------------------------------------------------------------------------------------
+	emList: Hashed list benchmark (PC)
+	File: lib_List_Bench.cpp
+
+    This file is part of emType. For more details, go through
+	Readme.txt. For copyright information, go through copyright.txt.
+
+    emType is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    emType is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with emType.  If not, see <http://www.gnu.org/licenses/>.
+----------------------------------------------------------------------------------------
+*/
+
+
+
+
+/*
+	Fills a list and a hashed list with the same number of pairs (fill level),
+	and prints the time taken per lookup (GetIndexFromKey), and per removal and
+	re-addition of a pair (Remove + Add), through a linear scan of the list, and
+	through the hash index of the hashed list. Build with a C++11 compiler,
+	e.g- g++ -O2 -I../lib_Type_CPP lib_List_Bench.cpp
+*/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include "embd.h"
+
+
+
+#define	Bench_Ops			1000000
+#define	Bench_Keys			4096
+
+
+
+emList_ByteByteMold256		List;
+emList_ByteByteHashMold256	HashList;
+byte						Keys[Bench_Keys];
+volatile uint				Sink;
+
+
+
+double BenchNow()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// returns the time per operation in ns, for lookups (mode 0) or remove + add (mode 1)
+double BenchLinear(uint fill, byte mode)
+{
+	uint i, sum = 0;
+	byte key, value = 0;
+	double start;
+	emList_InitLst(&List, 256);
+	for(i=0; i<fill; i++)
+	{
+		key = (byte)i;
+		emList_Add(&List, &key, &value);
+	}
+	start = BenchNow();
+	for(i=0; i<Bench_Ops; i++)
+	{
+		key = Keys[i & (Bench_Keys - 1)];
+		if(mode == 0) sum += emList_GetIndexFromKey(&List, &key);
+		else
+		{
+			emList_Remove(&List, &key);
+			emList_Add(&List, &key, &value);
+		}
+	}
+	Sink = sum;
+	return (BenchNow() - start) * 1e9 / Bench_Ops;
+}
+
+double BenchHash(uint fill, byte mode)
+{
+	uint i, sum = 0;
+	byte key, value = 0;
+	double start;
+	emList_HashInit(&HashList, 256);
+	for(i=0; i<fill; i++)
+	{
+		key = (byte)i;
+		emList_HashAdd(&HashList, &key, &value);
+	}
+	start = BenchNow();
+	for(i=0; i<Bench_Ops; i++)
+	{
+		key = Keys[i & (Bench_Keys - 1)];
+		if(mode == 0) sum += emList_HashGetIndexFromKey(&HashList, &key);
+		else
+		{
+			emList_HashRemove(&HashList, &key);
+			emList_HashAdd(&HashList, &key, &value);
+		}
+	}
+	Sink = sum;
+	return (BenchNow() - start) * 1e9 / Bench_Ops;
+}
+
+
+
+int main()
+{
+	static const uint fills[] = {8, 32, 64, 128, 192, 255};
+	uint f, i;
+	printf("fill\tlookup ns\t\tremove+add ns\n");
+	printf("\tlinear\thash\tlinear\thash\n");
+	for(f=0; f<sizeof(fills)/sizeof(fills[0]); f++)
+	{
+		// look up keys that are in the list
+		for(i=0; i<Bench_Keys; i++)
+			Keys[i] = (byte)((uint)rand() % fills[f]);
+		printf("%u\t%.1f\t%.1f\t%.1f\t%.1f\n", fills[f], BenchLinear(fills[f], 0), BenchHash(fills[f], 0),
+			BenchLinear(fills[f], 1), BenchHash(fills[f], 1));
+	}
+	return 0;
+}
@@ -0,0 +1,250 @@
+/*
+----------------------------------------------------------------------------------------
+	emStream: Throughput benchmark (PC)
+	File: lib_Stream_Bench.cpp
+
+    This file is part of emType. For more details, go through
+	Readme.txt. For copyright information, go through copyright.txt.
+
+    emType is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    emType is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with emType.  If not, see <http://www.gnu.org/licenses/>.
+----------------------------------------------------------------------------------------
+*/
+
+
+
+
+/*
+	Passes bytes through streams, and prints the bytes moved per cycle (of the
+	time stamp counter, on x86), next to the ways they are compared with. Build
+	with a C++11 compiler, e.g- g++ -O2 -pthread -I../lib_Type_CPP lib_Stream_Bench.cpp
+*/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include "embd.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+
+
+#define	Bench_Bytes			(1 << 26)
+
+
+
+emStream_Mold256		Stream;
+emStream_SpscMold256	Spsc;
+std::mutex				StreamLock;
+byte					Src[256], Dst[256];
+volatile uint			Sink;
+
+
+
+double BenchNow()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// cycles of the time stamp counter (or nanoseconds, if there is none)
+uint64 BenchCycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return (uint64)(BenchNow() * 1e9);
+#endif
+}
+
+
+
+// WriteBytesInt() / ReadBytesInt() as a loop of single bytes (as before the block copy)
+void BenchWriteLoop(emStream_Mold256* stm, byte* src, uint len)
+{
+	uint i;
+	if((uint)emStream_GetFree(stm) < len) return;
+	for(i=0; i<len; i++)
+	{
+		stm->Data[stm->Rear] = src[i];
+		stm->Rear = (stm->Rear + 1) & stm->Max;
+	}
+	stm->Count += len;
+}
+
+void BenchReadLoop(emStream_Mold256* stm, byte* dst, uint len)
+{
+	uint i;
+	if(emStream_GetAvail(stm) < len) return;
+	for(i=0; i<len; i++)
+	{
+		dst[i] = stm->Data[stm->Front];
+		stm->Front = (stm->Front + 1) & stm->Max;
+	}
+	stm->Count -= len;
+}
+
+void BenchWriteBlocks(emStream_Mold256* stm, byte* src, uint len)
+{
+	if((uint)emStream_GetFree(stm) >= len) emStream_WriteBytesSomeFn(stm, src, len);
+}
+
+void BenchReadBlocks(emStream_Mold256* stm, byte* dst, uint len)
+{
+	if(emStream_GetAvail(stm) >= len) emStream_ReadBytesSomeFn(stm, dst, len);
+}
+
+// WriteBytesInt() / ReadBytesInt() also post the event of the stream
+void BenchWriteInt(emStream_Mold256* stm, byte* src, uint len)
+{
+	emStream_WriteBytesInt(stm, src, len);
+}
+
+void BenchReadInt(emStream_Mold256* stm, byte* dst, uint len)
+{
+	emStream_ReadBytesInt(stm, dst, len);
+}
+
+// times writing and reading back chunks of len bytes through a stream of size bytes, in bytes per cycle
+double BenchCopyRun(void (*write)(emStream_Mold256*, byte*, uint), void (*read)(emStream_Mold256*, byte*, uint), uint size, uint len)
+{
+	uint reps = Bench_Bytes / len, i;
+	uint64 start;
+	emStream_Init(&Stream, size);
+	start = BenchCycles();
+	for(i=0; i<reps; i++)
+	{
+		write(&Stream, Src, len);
+		read(&Stream, Dst, len);
+	}
+	Sink = Dst[0];
+	return (double)reps * len / (double)(BenchCycles() - start);
+}
+
+void BenchCopy()
+{
+	uint size, len;
+	printf("Copy\tchunk\tloop B/cycle\tblocks B/cycle\tInt B/cycle\n");
+	for(size=8; size<=256; size <<= 1)
+	{
+		// chunks that do not divide the stream size, so that copies wrap around
+		len = (size * 3) / 8;
+		printf("%u\t%u\t%.2f\t%.2f\t%.2f\n", size, len, BenchCopyRun(BenchWriteLoop, BenchReadLoop, size, len),
+			BenchCopyRun(BenchWriteBlocks, BenchReadBlocks, size, len), BenchCopyRun(BenchWriteInt, BenchReadInt, size, len));
+	}
+	printf("\n");
+}
+
+
+
+// one thread writes chunks of len bytes (numbered), while another reads and checks them
+void BenchSpscProducer(uint len)
+{
+	byte src[64];
+	uint reps = Bench_Bytes / len, i;
+	for(i=0; i<reps; i++)
+	{
+		src[0] = (byte)i;
+		while(emStream_SpscWriteBytes(&Spsc, src, len))
+			std::this_thread::yield();
+	}
+}
+
+uint BenchSpscConsumer(uint len)
+{
+	byte dst[64];
+	uint reps = Bench_Bytes / len, i, bad = 0;
+	for(i=0; i<reps; i++)
+	{
+		while(emStream_SpscReadBytes(&Spsc, dst, len))
+			std::this_thread::yield();
+		bad += (dst[0] != (byte)i);
+	}
+	return bad;
+}
+
+// the same through a stream shared with a lock
+void BenchLockProducer(uint len)
+{
+	byte src[64];
+	uint reps = Bench_Bytes / len, i, done;
+	for(i=0; i<reps; i++)
+	{
+		src[0] = (byte)i;
+		for(done=0; !done; )
+		{
+			std::lock_guard<std::mutex> lock(StreamLock);
+			if((uint)emStream_GetFree(&Stream) >= len) done = emStream_WriteBytesSomeFn(&Stream, src, len);
+			else std::this_thread::yield();
+		}
+	}
+}
+
+uint BenchLockConsumer(uint len)
+{
+	byte dst[64];
+	uint reps = Bench_Bytes / len, i, bad = 0, done;
+	for(i=0; i<reps; i++)
+	{
+		for(done=0; !done; )
+		{
+			std::lock_guard<std::mutex> lock(StreamLock);
+			if(emStream_GetAvail(&Stream) >= len) done = emStream_ReadBytesSomeFn(&Stream, dst, len);
+			else std::this_thread::yield();
+		}
+		bad += (dst[0] != (byte)i);
+	}
+	return bad;
+}
+
+// times passing Bench_Bytes between two threads in chunks of len bytes, in MB/s
+double BenchSpscRun(void (*producer)(uint), uint (*consumer)(uint), uint len)
+{
+	double start;
+	uint bad;
+	emStream_SpscInit(&Spsc, 256);
+	emStream_Init(&Stream, 128);
+	start = BenchNow();
+	std::thread thread(producer, len);
+	bad = consumer(len);
+	thread.join();
+	if(bad) printf("(%u chunks out of order) ", bad);
+	return Bench_Bytes / (BenchNow() - start) / 1e6;
+}
+
+void BenchSpsc()
+{
+	static const uint lens[] = {1, 8, 16, 64};
+	uint f;
+	printf("Threads\tchunk\tSPSC MB/s\tlocked MB/s\n");
+	for(f=0; f<sizeof(lens)/sizeof(lens[0]); f++)
+		printf("2\t%u\t%.1f\t%.1f\n", lens[f], BenchSpscRun(BenchSpscProducer, BenchSpscConsumer, lens[f]),
+			BenchSpscRun(BenchLockProducer, BenchLockConsumer, lens[f]));
+	printf("\n");
+}
+
+
+
+int main()
+{
+	uint i;
+	for(i=0; i<sizeof(Src); i++)
+		Src[i] = (byte)rand();
+	BenchCopy();
+	BenchSpsc();
+	return 0;
+}
@@ -0,0 +1,107 @@
+/*
+----------------------------------------------------------------------------------------
+	emTask: Worker throughput benchmark (PC)
+	File: lib_Task_Bench.cpp
+
+    This file is part of emType. For more details, go through
+	Readme.txt. For copyright information, go through copyright.txt.
+
+    emType is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    emType is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with emType.  If not, see <http://www.gnu.org/licenses/>.
+----------------------------------------------------------------------------------------
+*/
+
+
+
+/*
+	Runs the same set of tasks with RunWorkers(1), RunWorkers(2), ... up to the
+	given number of workers (or the number of CPUs), and prints the number of task
+	slices run per second, and the speedup over a single worker. Each task does a
+	fixed amount of work in each slice, and then switches. Build with a C++11
+	compiler, e.g- g++ -O2 -pthread -I../lib_Type_CPP lib_Task_Bench.cpp
+*/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+#include <chrono>
+#include "embd.h"
+
+
+
+#define	Bench_Tasks			64
+#define	Bench_Slices		2000
+#define	Bench_Work			4000
+
+
+
+emList_TaskListMold		TaskList;
+emTask_Mold8			Task[Bench_Tasks];
+volatile uint			Sink;
+
+
+
+emTask_TaskFn(BenchTask, emTask_Mold8)
+{
+	uint i, sum;
+	emTask_Begin();
+	for((*emTask_Obj).Cursor = 0; (*emTask_Obj).Cursor < Bench_Slices; (*emTask_Obj).Cursor++)
+	{
+		for(i=0, sum=0; i<Bench_Work; i++)
+			sum += i ^ Sink;
+		Sink = sum;
+		emTask_Switch();
+	}
+	emTask_Exit(0);
+	emTask_End();
+}
+
+
+
+double BenchRun(byte workers)
+{
+	std::chrono::steady_clock::time_point start;
+	uint i;
+	emList_InitLst(&TaskList, 256);
+	emTask_InitMain(&TaskList);
+	for(i=0; i<Bench_Tasks; i++)
+	{
+		emTask_Init(&Task[i]);
+		emTask_Add(&Task[i], BenchTask);
+	}
+	start = std::chrono::steady_clock::now();
+	emTask_RunWorkers(workers);
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+
+int main(int argc, char* argv[])
+{
+	uint max = (argc > 1)? (uint)atoi(argv[1]) : std::thread::hardware_concurrency();
+	double slices = (double)Bench_Tasks * Bench_Slices, base = 0, secs;
+	uint workers;
+	if(max < 1) max = 1;
+	if(max > emTask_MaxWorkers) max = emTask_MaxWorkers;
+	printf("tasks: %d, slices per task: %d\n", Bench_Tasks, Bench_Slices);
+	printf("workers\tslices/s\tspeedup\n");
+	for(workers=1; workers<=max; workers++)
+	{
+		secs = BenchRun((byte)workers);
+		if(workers == 1) base = secs;
+		printf("%u\t%.0f\t%.2f\n", workers, slices / secs, base / secs);
+	}
+	return 0;
+}
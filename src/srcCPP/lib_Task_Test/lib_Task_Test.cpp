@@ -0,0 +1,185 @@
+/*
+----------------------------------------------------------------------------------------
+	emTask: Scheduler test (PC)
+	File: lib_Task_Test.cpp
+
+    This file is part of emType. For more details, go through
+	Readme.txt. For copyright information, go through copyright.txt.
+
+    emType is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    emType is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with emType.  If not, see <http://www.gnu.org/licenses/>.
+----------------------------------------------------------------------------------------
+*/
+
+
+
+/*
+	Checks the scheduler in the cases where tasks of different threads (workers)
+	meet. Prints each failed check, and returns the number of failed checks. Build
+	with a C++11 compiler, e.g- g++ -O2 -pthread -I../lib_Type_CPP lib_Task_Test.cpp,
+	and also with -fsanitize=thread to check for data races.
+*/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include "embd.h"
+
+
+
+#define	Test_Tasks			40
+#define	Test_Rounds			20
+#define	Test_LowRuns		100
+#define	Test_MaxPolls		1000000
+
+
+
+emList_TaskListMold		TaskList;
+emTask_Mold8			Spinner[Test_Tasks], Waiter[Test_Tasks], Sleeper[Test_Tasks], Killer;
+emTask_Mold8			High, Low;
+emTask_Event			Never;
+std::atomic<uint>		Runs;
+uint					LowRuns, HighPolls;
+uint					Fails;
+
+
+
+void TestCheck(int ok, const char* name, uint arg)
+{
+	if(ok) return;
+	printf("FAIL: %s (%u)\n", name, arg);
+	Fails++;
+}
+
+
+
+emTask_TaskFn(SpinTask, emTask_Mold8)
+{
+	emTask_Begin();
+	while(1)
+	{
+		Runs++;
+		emTask_Switch();
+	}
+	emTask_End();
+}
+
+emTask_TaskFn(WaitTask, emTask_Mold8)
+{
+	emTask_Begin();
+	emTask_WaitEventWhile(&Never, 1);
+	emTask_End();
+}
+
+emTask_TaskFn(SleepTask, emTask_Mold8)
+{
+	emTask_Begin();
+	emTask_Sleep(100000);
+	emTask_End();
+}
+
+// removes tasks that are running, in the queue of a worker, or waiting
+emTask_TaskFn(KillTask, emTask_Mold8)
+{
+	uint i;
+	emTask_Begin();
+	emTask_WaitWhile(Runs < 4 * Test_Tasks);
+	for(i=0; i<Test_Tasks; i++)
+	{
+		emTask_Remove(&Spinner[i]);
+		emTask_Remove(&Waiter[i]);
+		emTask_Remove(&Sleeper[i]);
+	}
+	emTask_Exit(0);
+	emTask_End();
+}
+
+void TestRemoveWorkers()
+{
+	uint round, i, left;
+	for(round=0; round<Test_Rounds; round++)
+	{
+		emList_InitLst(&TaskList, 256);
+		emTask_InitMain(&TaskList);
+		emTask_EventInit(&Never);
+		Runs = 0;
+		for(i=0; i<Test_Tasks; i++)
+		{
+			emTask_Init(&Spinner[i]);
+			emTask_Init(&Waiter[i]);
+			emTask_Init(&Sleeper[i]);
+			emTask_Add(&Spinner[i], SpinTask);
+			emTask_Add(&Waiter[i], WaitTask);
+			emTask_Add(&Sleeper[i], SleepTask);
+		}
+		emTask_Init(&Killer);
+		emTask_Add(&Killer, KillTask);
+		emTask_RunWorkers(4);
+		for(i=0, left=0; i<Test_Tasks; i++)
+			left += (Spinner[i].Queue != NULL) + (Waiter[i].Queue != NULL) + (Sleeper[i].Queue != NULL);
+		TestCheck(emTask_GetNumTasks() == 0, "RunWorkers tasks left", round);
+		TestCheck(left == 0 && Never.Head == NULL, "Remove left task queued", round);
+	}
+}
+
+
+
+// a high priority task polling with WaitWhile() on a low priority task
+emTask_TaskFn(HighTask, emTask_Mold8)
+{
+	emTask_Begin();
+	emTask_WaitWhile(LowRuns < Test_LowRuns && ++HighPolls < Test_MaxPolls);
+	emTask_Exit(0);
+	emTask_End();
+}
+
+emTask_TaskFn(LowTask, emTask_Mold8)
+{
+	emTask_Begin();
+	for(; LowRuns<Test_LowRuns; LowRuns++)
+		emTask_Switch();
+	emTask_Exit(0);
+	emTask_End();
+}
+
+void TestPolledWait()
+{
+	byte workers;
+	for(workers=0; workers<=1; workers++)
+	{
+		emList_InitLst(&TaskList, 256);
+		emTask_InitMain(&TaskList);
+		LowRuns = 0;
+		HighPolls = 0;
+		emTask_Init(&High);
+		emTask_Init(&Low);
+		High.Priority = emTask_Priorities - 1;
+		emTask_Add(&High, HighTask);
+		emTask_Add(&Low, LowTask);
+		if(workers) emTask_RunWorkers(workers);
+		else emTask_Run();
+		TestCheck(LowRuns == Test_LowRuns && HighPolls < Test_MaxPolls, "WaitWhile starves lower level", workers);
+	}
+}
+
+
+
+int main()
+{
+	TestRemoveWorkers();
+	TestPolledWait();
+	printf("%u checks failed\n", Fails);
+	return (int)Fails;
+}
@@ -0,0 +1,247 @@
+/*
+----------------------------------------------------------------------------------------
+	emType: Throughput benchmark (PC)
+	File: lib_Type_Bench.cpp
+
+    This file is part of emType. For more details, go through
+	Readme.txt. For copyright information, go through copyright.txt.
+
+    emType is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    emType is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with emType.  If not, see <http://www.gnu.org/licenses/>.
+----------------------------------------------------------------------------------------
+*/
+
+
+
+
+/*
+	Times emType functions over a buffer of random bytes, and prints the time
+	taken per call (or the bytes processed per second), next to the ways they
+	are compared with. Build with a C++11 compiler, e.g-
+	g++ -O2 -I../lib_Type_CPP lib_Type_Bench.cpp
+*/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include "embd.h"
+
+
+
+#define	Bench_Size			(1 << 20)
+#define	Bench_Ops			(1 << 24)
+#define	Bench_Bytes			(1 << 28)
+
+
+
+byte				Data[Bench_Size + 8];
+emType_Mold16		Union;
+volatile uint64		Sink;
+
+
+
+double BenchNow()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+
+// To<Type>() assembled through a union (stores to memory, and a load of the result)
+#define	BenchUnionToInt32(byte3, byte2, byte1, byte0)	\
+	((Union.Byte[0] = (byte0)), (Union.Byte[1] = (byte1)), (Union.Byte[2] = (byte2)), (Union.Byte[3] = (byte3)), Union.Int32[0])
+
+#define	BenchUnionToUint64(byte7, byte6, byte5, byte4, byte3, byte2, byte1, byte0)	\
+	((Union.Byte[0] = (byte0)), (Union.Byte[1] = (byte1)), (Union.Byte[2] = (byte2)), (Union.Byte[3] = (byte3)),	\
+	(Union.Byte[4] = (byte4)), (Union.Byte[5] = (byte5)), (Union.Byte[6] = (byte6)), (Union.Byte[7] = (byte7)), Union.Uint64[0])
+
+#define	BenchUnionToDouble(byte7, byte6, byte5, byte4, byte3, byte2, byte1, byte0)	\
+	(BenchUnionToUint64(byte7, byte6, byte5, byte4, byte3, byte2, byte1, byte0), Union.Double[0])
+
+// times an expression of the bytes at d, over the buffer, in ns per call
+#define	BenchTo(expr)	\
+	do{	\
+		uint64 sum = 0;	\
+		double start = BenchNow();	\
+		for(uint i=0; i<Bench_Ops; i++)	\
+		{	\
+			byte* d = Data + (i & (Bench_Size - 1));	\
+			sum += (uint64)(expr);	\
+		}	\
+		Sink = sum;	\
+		printf("\t%.2f", (BenchNow() - start) * 1e9 / Bench_Ops);	\
+	}while(0)
+
+void BenchToType()
+{
+	printf("To<Type>\tshifts ns\tunion ns\n");
+	printf("ToInt32");
+	BenchTo(emType_ToInt32(d[3], d[2], d[1], d[0]));
+	BenchTo(BenchUnionToInt32(d[3], d[2], d[1], d[0]));
+	printf("\nToUint64");
+	BenchTo(emType_ToUint64(d[7], d[6], d[5], d[4], d[3], d[2], d[1], d[0]));
+	BenchTo(BenchUnionToUint64(d[7], d[6], d[5], d[4], d[3], d[2], d[1], d[0]));
+	printf("\nToDouble");
+	BenchTo(emType_ToDouble(d[7], d[6], d[5], d[4], d[3], d[2], d[1], d[0]) > 0.5);
+	BenchTo(BenchUnionToDouble(d[7], d[6], d[5], d[4], d[3], d[2], d[1], d[0]) > 0.5);
+	printf("\n\n");
+}
+
+
+
+// Get<Type>BE/LE() and Put<Type>BE/LE() against assembling / splitting the value byte by byte
+void BenchOrder()
+{
+	printf("Order\taccessor ns\tbytes ns\n");
+	printf("GetUint32BE");
+	BenchTo(emType_GetUint32BE(d, 0));
+	BenchTo(((uint32)d[0] << 24) | ((uint32)d[1] << 16) | ((uint32)d[2] << 8) | d[3]);
+	printf("\nGetUint64LE");
+	BenchTo(emType_GetUint64LE(d, 0));
+	BenchTo(((uint64)d[7] << 56) | ((uint64)d[6] << 48) | ((uint64)d[5] << 40) | ((uint64)d[4] << 32) |
+		((uint64)d[3] << 24) | ((uint64)d[2] << 16) | ((uint64)d[1] << 8) | d[0]);
+	printf("\nPutUint32BE");
+	BenchTo((emType_PutUint32BE(d, 0, i), 0));
+	BenchTo((d[0] = (byte)(i >> 24), d[1] = (byte)(i >> 16), d[2] = (byte)(i >> 8), d[3] = (byte)i, 0));
+	printf("\n\n");
+}
+
+// DoSwap() as a loop of Get / Put accessors
+void BenchSwapWords(byte* src, uint count, byte size)
+{
+	uint i;
+	for(i=0; i<count; i++, src += size)
+	{
+		if(size == 2) emType_PutUint16BE(src, 0, emType_GetUint16LE(src, 0));
+		else if(size == 4) emType_PutUint32BE(src, 0, emType_GetUint32LE(src, 0));
+		else emType_PutUint64BE(src, 0, emType_GetUint64LE(src, 0));
+	}
+}
+
+// times swapping an array of len bytes in elements of size bytes, in GB/s
+double BenchSwapRun(void (*swap)(byte*, uint, byte), uint len, byte size)
+{
+	uint reps = Bench_Bytes / len, i;
+	double start = BenchNow();
+	for(i=0; i<reps; i++)
+		swap(Data + ((i * len) & (Bench_Size - 1)), len / size, size);
+	Sink = Data[0];
+	return (double)reps * len / (BenchNow() - start) / 1e9;
+}
+
+void BenchSwap()
+{
+	static const uint lens[] = {64, 4096, Bench_Size};
+	uint f;
+	byte size;
+	printf("DoSwap\tsize\taccessors GB/s\tDoSwap GB/s\n");
+	for(f=0; f<sizeof(lens)/sizeof(lens[0]); f++)
+		for(size=2; size<=8; size <<= 1)
+			printf("%u\t%u\t%.2f\t%.2f\n", lens[f], size, BenchSwapRun(BenchSwapWords, lens[f], size), BenchSwapRun(emType_DoSwapExtFn, lens[f], size));
+	printf("\n");
+}
+
+
+
+// DoReverse() as a loop of byte swaps (as before the block kernels)
+void BenchReverseBytes(byte* src, int off, int len)
+{
+	byte byt, *end;
+	for(src += off, end=src+len-1; src<end; src++, end--)
+	{
+		byt = *src;
+		*src = *end;
+		*end = byt;
+	}
+}
+
+void BenchReverseWords(byte* src, int off, int len)
+{
+	if(len > 1) emType_DoReverseScalar(src + off, src + off + len);
+}
+
+// times reversing blocks of len bytes, in GB/s
+double BenchReverseRun(void (*reverse)(byte*, int, int), int len)
+{
+	uint reps = Bench_Bytes / (uint)len, i;
+	double start = BenchNow();
+	for(i=0; i<reps; i++)
+		reverse(Data, (int)((i * (uint)len) & (Bench_Size - 1)), len);
+	Sink = Data[0];
+	return (double)reps * len / (BenchNow() - start) / 1e9;
+}
+
+void BenchReverse()
+{
+	int len;
+	printf("DoReverse	bytes GB/s	words GB/s	DoReverse GB/s\n");
+	for(len=16; len<=Bench_Size; len <<= 2)
+		printf("%d\t%.2f\t%.2f\t%.2f\n", len, BenchReverseRun(BenchReverseBytes, len),
+			BenchReverseRun(BenchReverseWords, len), BenchReverseRun(emType_DoReverseExtFn, len));
+	printf("\n");
+}
+
+
+
+// times a check of len bytes at src, over blocks of len bytes, in GB/s
+#define	BenchCheck(expr)	\
+	do{	\
+		uint reps = Bench_Bytes / len, i;	\
+		uint64 sum = 0;	\
+		double start = BenchNow();	\
+		for(i=0; i<reps; i++)	\
+		{	\
+			byte* src = Data + ((i * len) & (Bench_Size - 1));	\
+			sum += (uint64)(expr);	\
+		}	\
+		Sink = sum;	\
+		printf("\t%.2f", (double)reps * len / (BenchNow() - start) / 1e9);	\
+	}while(0)
+
+void BenchCrc()
+{
+	static const uint lens[] = {64, 1500, Bench_Size};
+	uint f, len;
+	printf("Checks GB/s\tByteSum\tUshortSum\tCrc16\tCrc32\tCrc32 tables\tCrc32C\tCrc32C tables\n");
+	for(f=0; f<sizeof(lens)/sizeof(lens[0]); f++)
+	{
+		len = lens[f];
+		printf("%u", len);
+		BenchCheck(emType_GetByteSum(src, 0, len));
+		BenchCheck(emType_GetUshortSum(src, 0, len));
+		BenchCheck(emType_GetCrc16(src, 0, len));
+		BenchCheck(emType_GetCrc32(src, 0, len));
+		BenchCheck(emType_Crc32Slice(0xFFFFFFFF, src, len));
+		BenchCheck(emType_GetCrc32C(src, 0, len));
+		BenchCheck(emType_Crc32CSlice(0xFFFFFFFF, src, len));
+		printf("\n");
+	}
+	printf("\n");
+}
+
+
+
+int main()
+{
+	uint i;
+	for(i=0; i<sizeof(Data); i++)
+		Data[i] = (byte)rand();
+	BenchToType();
+	BenchOrder();
+	BenchSwap();
+	BenchReverse();
+	BenchCrc();
+	return 0;
+}
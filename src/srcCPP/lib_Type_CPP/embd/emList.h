@@ -53,6 +53,44 @@
 
 
 
+// Select index width
+// 
+// The index width (8, 16 or 32 bits) is the size of the Count and
+// Max fields of list molds, and of the indexes used by this library.
+// It limits the size of a list to 256, 65536 or 2^32 pairs. The
+// default is 8 bits, which keeps the small footprint on AVR. Lists
+// wider than 8 bits also use a 32-bit offset to their values. The
+// index width can be selected in the main header file of embd library
+#ifndef	emList_IndexWidth
+#define	emList_IndexWidth	8
+#endif
+
+#if	emList_IndexWidth == 32
+#define	emList_Index		emType_Bits32
+#define	emList_IndexNone	0xFFFFFFFF
+#define	emList_Offset		int32
+#elif	emList_IndexWidth == 16
+#define	emList_Index		uint16
+#define	emList_IndexNone	0xFFFF
+#define	emList_Offset		int32
+#else
+#define	emList_Index		byte
+#define	emList_IndexNone	0xFF
+#define	emList_Offset		int16
+#endif
+
+#if emList_Shorthand >= 1
+#define	list_Index				emList_Index
+#define	list_IndexNone			emList_IndexNone
+#endif
+
+#if	emList_Shorthand >= 2
+#define	lstIndex				emList_Index
+#define	lstIndexNone			emList_IndexNone
+#endif
+
+
+
 // List Mold Making
 // 
 // List molds (structures) can be created with desired sizes and datatypes. The MoldMake() can be used to
@@ -62,10 +100,11 @@
 #define	emList_MoldMake(name, key, value, size)	\
 typedef struct _emList_##name##Mold##size	\
 {	\
-	byte	Count;	\
-	byte	Max;	\
+	emList_Index	Count;	\
+	emList_Index	Max;	\
 	byte	KeyLen;	\
 	byte	ValueLen;	\
+	emList_Offset	ValueOff;	\
 	key		Key[size];	\
 	value	Value[size];	\
 }emList_##name##Mold##size
@@ -73,10 +112,11 @@ typedef struct _emList_##name##Mold##size	\
 #define	emList_MoldMake(name, key, value, size)	\
 typedef struct _emList_##name##Mold##size	\
 {	\
-	byte	Count;	\
-	byte	Max;	\
+	emList_Index	Count;	\
+	emList_Index	Max;	\
 	byte	KeyLen;	\
 	byte	ValueLen;	\
+	emList_Offset	ValueOff;	\
 	key		Key[size];	\
 	value	Value[size];	\
 }emList_##name##Mold##size, list_##name##Mold##size
@@ -84,11 +124,11 @@ typedef struct _emList_##name##Mold##size	\
 #define	emList_MoldMake(name, key, value, size)	\
 typedef struct _emList_##name##Mold##size	\
 {	\
-	byte	Count;	\
-	byte	Max;	\
+	emList_Index	Count;	\
+	emList_Index	Max;	\
 	byte	KeyLen;	\
 	byte	ValueLen;	\
-	int16	ValueOff;	\
+	emList_Offset	ValueOff;	\
 	key		Key[size];	\
 	value	Value[size];	\
 }emList_##name##Mold##size, list_##name##Mold##size, lst##name##Mold##size
@@ -138,7 +178,7 @@ emList_MoldMake(ByteByte, byte, byte, 256);
 		(*(list)).Max = (size) - 1;	\
 		(*(list)).KeyLen = sizeof((*(list)).Key[0]);	\
 		(*(list)).ValueLen = sizeof((*(list)).Value[0]);	\
-		(*(list)).ValueOff = (size) * sizeof((*(list)).Key[0]);	\
+		(*(list)).ValueOff = (emList_Offset)((byte*)(*(list)).Value - (byte*)(*(list)).Key);	\
 	}while(0)
 
 #if emList_Shorthand >= 1
@@ -235,46 +275,117 @@ emList_MoldMake(ByteByte, byte, byte, 256);
 
 
 
+// Function:
+// IsElemEqual(*elem1, *elem2, elem_size)
+// 
+// Compares two elements (keys or values) of specified size (elem_size),
+// and stops at the first difference. Wide elements are compared 32 / 16
+// bytes at a time (using AVX2 / SSE2 on PC), and then word by word.
+// 
+// Parameters:
+// elem1:		the first element
+// elem2:		the second element
+// elem_size:	size of each element in bytes
+// 
+// Returns:
+// is_equal:	TRUE if both elements are equal, else FALSE
+//
+byte emList_IsElemEqualFn(byte* elem1, byte* elem2, byte elem_size)
+{
+	emType_Bits32 word1, word2;
+#if defined(emType_AVX2)
+	for(; elem_size >= 32; elem_size -= 32, elem1 += 32, elem2 += 32)
+	{
+		if(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((__m256i*)elem1), _mm256_loadu_si256((__m256i*)elem2))) != -1) return FALSE;
+	}
+#endif
+#if defined(emType_SSE2)
+	for(; elem_size >= 16; elem_size -= 16, elem1 += 16, elem2 += 16)
+	{
+		if(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((__m128i*)elem1), _mm_loadu_si128((__m128i*)elem2))) != 0xFFFF) return FALSE;
+	}
+#endif
+	for(; elem_size >= 4; elem_size -= 4, elem1 += 4, elem2 += 4)
+	{
+		memcpy(&word1, elem1, 4);
+		memcpy(&word2, elem2, 4);
+		if(word1 != word2) return FALSE;
+	}
+	for(; elem_size; elem_size--, elem1++, elem2++)
+	{
+		if(*elem1 != *elem2) return FALSE;
+	}
+	return TRUE;
+}
+
+#define	emList_IsElemEqual(elem1, elem2, elem_size)	\
+	emList_IsElemEqualFn((byte*)(elem1), (byte*)(elem2), (byte)(elem_size))
+
+#if emList_Shorthand >= 1
+#define	list_IsElemEqual		emList_IsElemEqual
+#endif
+
+#if	emList_Shorthand >= 2
+#define	lstIsElemEqual			emList_IsElemEqual
+#endif
+
+
+
 // Function:
 // GetIndexFrom<Key/Value>(*list, *<key/value>)
 // 
-// Get the index of a <key/value> from the list.
+// Get the index of a <key/value> from the list. Keys / values of 1, 2,
+// 4 and 8 bytes are compared as a single word, and wider ones are
+// compared with IsElemEqual().
 // 
 // Parameters:
 // list:	the list from which index of <key/value> is required
 // <key/value>:	the <key/value>, whose index in the list is required
 // 
 // Returns: (nothing if index is provided as parameter)
-// index:	index of <key/value> (0xFF for not found)
+// index:	index of <key/value> (emList_IndexNone for not found)
 //
-byte emList_GetIndexFromElemFn(void* list, void* list_elements, byte elem_size, void* element)
+#define	emList_GetIndexFromWord(type)	\
+	do{	\
+		type word, elem_word;	\
+		memcpy(&word, element, sizeof(type));	\
+		for(i=0; i<count; i++, elems += sizeof(type))	\
+		{	\
+			memcpy(&elem_word, elems, sizeof(type));	\
+			if(elem_word == word) return i;	\
+		}	\
+		return emList_IndexNone;	\
+	}while(0)
+
+emList_Index emList_GetIndexFromElemFn(void* list, void* list_elements, byte elem_size, void* element)
 {
-	byte index = 0xFF;
-	byte *elems = (byte*)list_elements, *elem = (byte*)element;
-	byte i, j, mtch, count = ((emList_ByteByteMold256*)list)->Count;
-	for(i=0; i<count; i++)
+	byte *elems = (byte*)list_elements;
+	emList_Index i, count = ((emList_ByteByteMold256*)list)->Count;
+	switch(elem_size)
 	{
-		mtch = 0;
-		for(j=0; j<elem_size; j++, elems++)
-		{
-			if(elem[j] == *elems) mtch++;
-		}
-		if(mtch == elem_size) {index = i; break;}
+		case 1:	emList_GetIndexFromWord(byte);
+		case 2:	emList_GetIndexFromWord(ushort);
+		case 4:	emList_GetIndexFromWord(emType_Bits32);
+		case 8:	emList_GetIndexFromWord(uint64);
 	}
-	return index;
+	for(i=0; i<count; i++, elems += elem_size)
+	{
+		if(emList_IsElemEqualFn(elems, (byte*)element, elem_size)) return i;
+	}
+	return emList_IndexNone;
 }
 
 #define	emList_GetIndexFromKeyLst(list, key)	\
 	emList_GetIndexFromElemFn(list, (*(list)).Key, (*(list)).KeyLen, key)
 
 #define	emList_GetIndexFromKey(list, key)	\
-	emList_GetIndexFromKeyLst((emList_ByteByteMold*)list, key)
+	emList_GetIndexFromElemFn(list, (*(list)).Key, sizeof((*(list)).Key[0]), key)
 
 #define	emList_GetIndexFromValueLst(list, value)	\
 	emList_GetIndexFromElemFn(list, (*(list)).Value, (*(list)).ValueLen, value)
 
 #define	emList_GetIndexFromValue(list, value)	\
-	emList_GetIndexFromValueLst((emList_ByteByteMold*)list, key)
+	emList_GetIndexFromElemFn(list, (*(list)).Value, sizeof((*(list)).Value[0]), value)
 
 #if emList_Shorthand >= 1
 #define	list_GetIndexFromKey	emList_GetIndexFromKey
@@ -303,24 +414,25 @@ byte emList_GetIndexFromElemFn(void* list, void* list_elements, byte elem_size,
 // Returns:
 // status:	0 for success, 0xFF for full
 //
-byte emList_Add(void* list, void* key, void* value)
+byte emList_AddFn(void* list, void* list_keys, void* list_values, byte key_size, byte value_size, void* key, void* value)
 {
-	byte *ukey, *uval, *dst, i, indx;
+	emList_Index indx;
 	emList_ByteByteMold256* lst = (emList_ByteByteMold256*)list;
-	if((*lst).Count > (*lst).Max) return 0xFF;	// list is full
-	ukey = (byte*)key;
-	uval = (byte*)value;
-	indx = emList_GetIndexFromKey(lst, key);
-	if(indx == 0xFF) {indx = (*(lst)).Count; (*(lst)).Count++; }
-	dst = (byte*)((*lst).Key) + ((*lst).KeyLen * indx);
-	for(i=0; i<(*lst).KeyLen; i++)
-		dst[i] = ukey[i];
-	dst = (byte*)((*lst).Key) + ((*lst).ValueOff) + ((*lst).ValueLen * indx);
-	for(i=0; i<(*lst).ValueLen; i++)
-		dst[i] = uval[i];
+	indx = emList_GetIndexFromElemFn(list, list_keys, key_size, key);
+	if(indx == emList_IndexNone)
+	{
+		if(lst->Count > lst->Max) return 0xFF;	// list is full
+		indx = lst->Count;
+		lst->Count++;
+	}
+	memcpy((byte*)list_keys + (key_size * indx), key, key_size);
+	memcpy((byte*)list_values + (value_size * indx), value, value_size);
 	return 0;
 }
 
+#define	emList_Add(list, key, value)	\
+	emList_AddFn(list, (*(list)).Key, (*(list)).Value, sizeof((*(list)).Key[0]), sizeof((*(list)).Value[0]), key, value)
+
 #if emList_Shorthand >= 1
 #define	list_Add				emList_Add
 #endif
@@ -344,7 +456,7 @@ byte emList_Add(void* list, void* key, void* value)
 // Returns:
 // status:	0 for success, 0xFF for empty
 //
-byte emList_RemoveAtFn(void* list, void* list_keys, void* list_values, byte key_size, byte value_size, byte index)
+byte emList_RemoveAtFn(void* list, void* list_keys, void* list_values, byte key_size, byte value_size, emList_Index index)
 {
 	emList_ByteByteMold256* lst = (emList_ByteByteMold256*)list;
 	if(index >= (lst->Count)) return 0xFF;	// empty
@@ -393,8 +505,8 @@ byte emList_RemoveAtFn(void* list, void* list_keys, void* list_values, byte key_
 //
 byte emList_RemoveFn(void* list, void* list_keys, void* list_values, byte key_size, byte value_size, void* key)
 {
-	byte index = emList_GetIndexFromElemFn(list, list_keys, key_size, key);
-	if(index == 0xFF) return 0xFF;
+	emList_Index index = emList_GetIndexFromElemFn(list, list_keys, key_size, key);
+	if(index == emList_IndexNone) return 0xFF;
 	return emList_RemoveAtFn(list, list_keys, list_values, key_size, value_size, index);
 }
 
@@ -411,4 +523,628 @@ byte emList_RemoveFn(void* list, void* list_keys, void* list_values, byte key_si
 
 
 
+// Function:
+// RemoveAtUnordered(*list, index)
+// 
+// Removes a key-value pair at specified index of list (index), by moving the
+// last key-value pair into its place. This takes constant time, but does not
+// preserve the order of the remaining key-value pairs. If specified index is
+// empty the removal cannot be done (status will be -1)
+// 
+// Parameters:
+// list:	the list from which a key-value pair is to be removed
+// index:	index of the key-value pair to be removed
+// 
+// Returns:
+// status:	0 for success, 0xFF for empty
+//
+byte emList_RemoveAtUnorderedFn(void* list, void* list_keys, void* list_values, byte key_size, byte value_size, emList_Index index)
+{
+	emList_ByteByteMold256* lst = (emList_ByteByteMold256*)list;
+	if(index >= (lst->Count)) return 0xFF;	// empty
+	byte *keys = (byte*)list_keys, *values = (byte*)list_values;
+	emList_Index last = lst->Count - 1;
+	if(index != last)
+	{
+		memcpy(keys + (key_size * index), keys + (key_size * last), key_size);
+		memcpy(values + (value_size * index), values + (value_size * last), value_size);
+	}
+	lst->Count--;
+	return 0;
+}
+
+#define	emList_RemoveAtUnordered(list, index)	\
+	emList_RemoveAtUnorderedFn(list, (*(list)).Key, (*(list)).Value, sizeof((*(list)).Key[0]), sizeof((*(list)).Value[0]), index)
+
+#if emList_Shorthand >= 1
+#define	list_RemoveAtUnordered	emList_RemoveAtUnordered
+#endif
+
+#if	emList_Shorthand >= 2
+#define	lstRemoveAtUnordered	emList_RemoveAtUnordered
+#endif
+
+
+
+// Function:
+// RemoveUnordered(*list, *key)
+// 
+// Removes a key-value pair having specified key (key), by moving the last
+// key-value pair into its place (order is not preserved). If specified
+// key is not present the removal cannot be done (status will be -1)
+// 
+// Parameters:
+// list:	the list from which a key-value pair is to be removed
+// key:		key of the key-value pair to be removed
+// 
+// Returns:
+// status:	0 for success, 0xFF for unavailable
+//
+byte emList_RemoveUnorderedFn(void* list, void* list_keys, void* list_values, byte key_size, byte value_size, void* key)
+{
+	emList_Index index = emList_GetIndexFromElemFn(list, list_keys, key_size, key);
+	if(index == emList_IndexNone) return 0xFF;
+	return emList_RemoveAtUnorderedFn(list, list_keys, list_values, key_size, value_size, index);
+}
+
+#define	emList_RemoveUnordered(list, key)	\
+	emList_RemoveUnorderedFn(list, (*(list)).Key, (*(list)).Value, sizeof((*(list)).Key[0]), sizeof((*(list)).Value[0]), key)
+
+#if emList_Shorthand >= 1
+#define	list_RemoveUnordered	emList_RemoveUnordered
+#endif
+
+#if	emList_Shorthand >= 2
+#define	lstRemoveUnordered		emList_RemoveUnordered
+#endif
+
+
+
+// Function:
+// RemoveIf(*list, pred, *param)
+// 
+// Removes all key-value pairs for which the predicate function (pred) returns
+// non-zero. The list is compacted in a single pass, and the order of the
+// remaining key-value pairs is preserved.
+// 
+// Parameters:
+// list:	the list from which key-value pairs are to be removed
+// pred:	predicate function, called as pred(key, value, param)
+// param:	parameter passed on to the predicate function
+// 
+// Returns:
+// removed:	number of key-value pairs removed
+//
+typedef byte (*emList_PredFnPtr)(void* key, void* value, void* param);
+
+emList_Index emList_RemoveIfFn(void* list, void* list_keys, void* list_values, byte key_size, byte value_size, emList_PredFnPtr pred, void* param)
+{
+	emList_ByteByteMold256* lst = (emList_ByteByteMold256*)list;
+	byte *keys = (byte*)list_keys, *values = (byte*)list_values;
+	byte *key, *value;
+	emList_Index i, j, count = lst->Count;
+	for(i=0, j=0; i<count; i++)
+	{
+		key = keys + (key_size * i);
+		value = values + (value_size * i);
+		if((*pred)(key, value, param)) continue;
+		if(i != j)
+		{
+			memcpy(keys + (key_size * j), key, key_size);
+			memcpy(values + (value_size * j), value, value_size);
+		}
+		j++;
+	}
+	lst->Count = j;
+	return count - j;
+}
+
+#define	emList_RemoveIf(list, pred, param)	\
+	emList_RemoveIfFn(list, (*(list)).Key, (*(list)).Value, sizeof((*(list)).Key[0]), sizeof((*(list)).Value[0]), (emList_PredFnPtr)(pred), (void*)(param))
+
+#if emList_Shorthand >= 1
+#define	list_PredFnPtr			emList_PredFnPtr
+#define	list_RemoveIf			emList_RemoveIf
+#endif
+
+#if	emList_Shorthand >= 2
+#define	lstPredFnPtr			emList_PredFnPtr
+#define	lstRemoveIf				emList_RemoveIf
+#endif
+
+
+
+// Sorted List
+//
+// A list made with MoldMake() can also be kept sorted by key, so that a key can be
+// found with a binary search (in logarithmic time), and keys within a range can be
+// scanned in order directly from the list. Keys of 1, 2, 4 or 8 bytes are ordered
+// as unsigned integers, and all other keys are ordered byte-wise. A sorted list
+// must be modified only through Sorted<function_name>() functions (or RemoveAt(),
+// which preserves order). Keys in a range [lo, hi] can be scanned as:
+// for(i = SortedLowerBound(&list, &lo), end = SortedUpperBound(&list, &hi); i < end; i++)
+//
+
+
+
+// Function:
+// CompareKey(*key1, *key2, key_size)
+//
+// Compares two keys of given size (key_size) in the order used by sorted lists.
+//
+// Parameters:
+// key1:		the first key
+// key2:		the second key
+// key_size:	size of each key
+//
+// Returns:
+// order:		negative if key1 < key2, 0 if equal, positive if key1 > key2
+//
+#define	emList_CompareKeyWord(type)	\
+	{	\
+		type word1, word2;	\
+		memcpy(&word1, key1, sizeof(type));	\
+		memcpy(&word2, key2, sizeof(type));	\
+		return (word1 > word2) - (word1 < word2);	\
+	}
+
+int emList_CompareKeyFn(void* key1, void* key2, byte key_size)
+{
+	switch(key_size)
+	{
+		case 1:	emList_CompareKeyWord(byte)
+		case 2:	emList_CompareKeyWord(uint16)
+		case 4:	emList_CompareKeyWord(emType_Bits32)
+		case 8:	emList_CompareKeyWord(unsigned long long)
+	}
+	return memcmp(key1, key2, key_size);
+}
+
+#define	emList_CompareKey(key1, key2, key_size)	\
+	emList_CompareKeyFn((void*)(key1), (void*)(key2), (byte)(key_size))
+
+#if emList_Shorthand >= 1
+#define	list_CompareKey			emList_CompareKey
+#endif
+
+#if	emList_Shorthand >= 2
+#define	lstCompareKey			emList_CompareKey
+#endif
+
+
+
+// Function:
+// SortedLowerBound(*list, *key)
+// SortedUpperBound(*list, *key)
+//
+// Finds the index of the first key in a sorted list which is not less than
+// (lower bound), or greater than (upper bound) the specified key (key).
+//
+// Parameters:
+// list:	the sorted list to be searched
+// key:		the key to be searched for
+//
+// Returns:
+// index:	index of the first such key, or the number of keys if none
+//
+emList_Index emList_SortedBoundFn(void* list, void* list_keys, byte key_size, void* key, byte upper)
+{
+	byte* keys = (byte*)list_keys;
+	emList_Index lo = 0, hi = ((emList_ByteByteMold256*)list)->Count, mid;
+	int cmp;
+	while(lo < hi)
+	{
+		mid = lo + ((hi - lo) >> 1);
+		cmp = emList_CompareKeyFn(keys + (key_size * mid), key, key_size);
+		if(cmp < 0 || (upper && cmp == 0)) lo = mid + 1;
+		else hi = mid;
+	}
+	return lo;
+}
+
+#define	emList_SortedLowerBound(list, key)	\
+	emList_SortedBoundFn(list, (*(list)).Key, sizeof((*(list)).Key[0]), key, 0)
+
+#define	emList_SortedUpperBound(list, key)	\
+	emList_SortedBoundFn(list, (*(list)).Key, sizeof((*(list)).Key[0]), key, 1)
+
+#if emList_Shorthand >= 1
+#define	list_SortedLowerBound	emList_SortedLowerBound
+#define	list_SortedUpperBound	emList_SortedUpperBound
+#endif
+
+#if	emList_Shorthand >= 2
+#define	lstSortedLowerBound		emList_SortedLowerBound
+#define	lstSortedUpperBound		emList_SortedUpperBound
+#endif
+
+
+
+// Function:
+// SortedGetIndexFromKey(*list, *key)
+//
+// Gives the index of specified key (key) in a sorted list, using binary search.
+//
+// Parameters:
+// list:	the sorted list to be searched
+// key:		the key to be searched for
+//
+// Returns:
+// index:	index of the key, emList_IndexNone if not found
+//
+emList_Index emList_SortedGetIndexFromKeyFn(void* list, void* list_keys, byte key_size, void* key)
+{
+	emList_Index index = emList_SortedBoundFn(list, list_keys, key_size, key, 0);
+	if(index >= ((emList_ByteByteMold256*)list)->Count) return emList_IndexNone;
+	if(!emList_IsElemEqualFn((byte*)list_keys + (key_size * index), (byte*)key, key_size)) return emList_IndexNone;
+	return index;
+}
+
+#define	emList_SortedGetIndexFromKey(list, key)	\
+	emList_SortedGetIndexFromKeyFn(list, (*(list)).Key, sizeof((*(list)).Key[0]), key)
+
+#if emList_Shorthand >= 1
+#define	list_SortedGetIndexFromKey	emList_SortedGetIndexFromKey
+#endif
+
+#if	emList_Shorthand >= 2
+#define	lstSortedGetIndexFromKey	emList_SortedGetIndexFromKey
+#endif
+
+
+
+// Function:
+// SortedAdd(*list, *key, *value)
+//
+// Adds a key-value pair to a sorted list, at its place in key order. If
+// another key-value pair exists with the same key, then it will be
+// overwritten. If sufficient space is not available, then the key-value
+// pair will not be added.
+//
+// Parameters:
+// list:	the sorted list to which the key-value pair is to be added
+// key:		the key to be added
+// value:	the value to be added to list along with key
+//
+// Returns:
+// status:	0 for success, 0xFF for full
+//
+byte emList_SortedAddFn(void* list, void* list_keys, void* list_values, byte key_size, byte value_size, void* key, void* value)
+{
+	emList_ByteByteMold256* lst = (emList_ByteByteMold256*)list;
+	byte *keys = (byte*)list_keys, *values = (byte*)list_values;
+	emList_Index index = emList_SortedBoundFn(list, list_keys, key_size, key, 0);
+	if(index >= lst->Count || !emList_IsElemEqualFn(keys + (key_size * index), (byte*)key, key_size))
+	{
+		if(lst->Count > lst->Max) return 0xFF;	// list is full
+		memmove(keys + (key_size * (index + 1)), keys + (key_size * index), key_size * (lst->Count - index));
+		memmove(values + (value_size * (index + 1)), values + (value_size * index), value_size * (lst->Count - index));
+		lst->Count++;
+	}
+	memcpy(keys + (key_size * index), key, key_size);
+	memcpy(values + (value_size * index), value, value_size);
+	return 0;
+}
+
+#define	emList_SortedAdd(list, key, value)	\
+	emList_SortedAddFn(list, (*(list)).Key, (*(list)).Value, sizeof((*(list)).Key[0]), sizeof((*(list)).Value[0]), key, value)
+
+#if emList_Shorthand >= 1
+#define	list_SortedAdd			emList_SortedAdd
+#endif
+
+#if	emList_Shorthand >= 2
+#define	lstSortedAdd			emList_SortedAdd
+#endif
+
+
+
+// Function:
+// SortedRemove(*list, *key)
+//
+// Removes a key-value pair having specified key (key) from a sorted list,
+// using binary search. If specified key is not present the removal cannot
+// be done (status will be -1)
+//
+// Parameters:
+// list:	the sorted list from which a key-value pair is to be removed
+// key:		key of the key-value pair to be removed
+//
+// Returns:
+// status:	0 for success, 0xFF for unavailable
+//
+byte emList_SortedRemoveFn(void* list, void* list_keys, void* list_values, byte key_size, byte value_size, void* key)
+{
+	emList_Index index = emList_SortedGetIndexFromKeyFn(list, list_keys, key_size, key);
+	if(index == emList_IndexNone) return 0xFF;
+	return emList_RemoveAtFn(list, list_keys, list_values, key_size, value_size, index);
+}
+
+#define	emList_SortedRemove(list, key)	\
+	emList_SortedRemoveFn(list, (*(list)).Key, (*(list)).Value, sizeof((*(list)).Key[0]), sizeof((*(list)).Value[0]), key)
+
+#if emList_Shorthand >= 1
+#define	list_SortedRemove		emList_SortedRemove
+#endif
+
+#if	emList_Shorthand >= 2
+#define	lstSortedRemove			emList_SortedRemove
+#endif
+
+
+
+// Hashed List Mold Making
+//
+// Hashed list molds have the same layout as list molds, followed by an open-addressing
+// hash index (Hash) of twice the size of the list, which stores the index of each key
+// in the list (emList_IndexNone for empty). Lookups through the hash index take
+// constant time on average. The HashMoldMake() can be used to create such molds, and
+// objects can then be created as <name>HashMold<size> <object>. The size must be a
+// power of 2, and one cell is kept unused (a hashed list can store upto size - 1
+// pairs). A hashed list must be modified only through Hash<function_name>() functions.
+//
+#if	emList_Shorthand == 0
+#define	emList_HashMoldMake(name, key, value, size)	\
+typedef struct _emList_##name##HashMold##size	\
+{	\
+	emList_Index	Count;	\
+	emList_Index	Max;	\
+	byte	KeyLen;	\
+	byte	ValueLen;	\
+	emList_Offset	ValueOff;	\
+	key		Key[size];	\
+	value	Value[size];	\
+	emList_Index	Hash[(size) << 1];	\
+}emList_##name##HashMold##size
+#elif	emList_Shorthand == 1
+#define	emList_HashMoldMake(name, key, value, size)	\
+typedef struct _emList_##name##HashMold##size	\
+{	\
+	emList_Index	Count;	\
+	emList_Index	Max;	\
+	byte	KeyLen;	\
+	byte	ValueLen;	\
+	emList_Offset	ValueOff;	\
+	key		Key[size];	\
+	value	Value[size];	\
+	emList_Index	Hash[(size) << 1];	\
+}emList_##name##HashMold##size, list_##name##HashMold##size
+#elif	emList_Shorthand == 2
+#define	emList_HashMoldMake(name, key, value, size)	\
+typedef struct _emList_##name##HashMold##size	\
+{	\
+	emList_Index	Count;	\
+	emList_Index	Max;	\
+	byte	KeyLen;	\
+	byte	ValueLen;	\
+	emList_Offset	ValueOff;	\
+	key		Key[size];	\
+	value	Value[size];	\
+	emList_Index	Hash[(size) << 1];	\
+}emList_##name##HashMold##size, list_##name##HashMold##size, lst##name##HashMold##size
+#endif
+
+#if emList_Shorthand >= 1
+#define	list_HashMoldMake		emList_HashMoldMake
+#endif
+
+#if	emList_Shorthand >= 2
+#define	lstHashMoldMake			emList_HashMoldMake
+#endif
+
+emList_HashMoldMake(ByteByte, byte, byte, 256);
+
+#define	emList_ByteByteHashMold		emList_ByteByteHashMold256
+
+#if emList_Shorthand >= 1
+#define	list_ByteByteHashMold256	emList_ByteByteHashMold256
+#define	list_ByteByteHashMold		emList_ByteByteHashMold
+#endif
+
+#if	emList_Shorthand >= 2
+#define	lstByteByteHashMold256		emList_ByteByteHashMold256
+#define	lstByteByteHashMold			emList_ByteByteHashMold
+#endif
+
+
+
+// Function:
+// HashInit(*list, size)
+// HashClear(*list)
+//
+// Initializes a hashed list before use, or clears a hashed list of all
+// data. The size of list (size) is required to be specified so that the
+// list can be initialized according to its size.
+//
+// Parameters:
+// list:	the hashed list to initialize / clear (must be direct pointer to list)
+// size:	size of the list to be initialized
+//
+// Returns:
+// nothing
+//
+#define	emList_HashInit(list, size)	\
+	do{	\
+		emList_InitLst(list, size);	\
+		memset((*(list)).Hash, 0xFF, sizeof((*(list)).Hash));	\
+	}while(0)
+
+#define	emList_HashClear(list)	\
+	do{	\
+		(*(list)).Count = 0;	\
+		memset((*(list)).Hash, 0xFF, sizeof((*(list)).Hash));	\
+	}while(0)
+
+#if emList_Shorthand >= 1
+#define	list_HashInit			emList_HashInit
+#define	list_HashClear			emList_HashClear
+#endif
+
+#if	emList_Shorthand >= 2
+#define	lstHashInit				emList_HashInit
+#define	lstHashClear			emList_HashClear
+#endif
+
+
+
+// Function:
+// HashGetIndexFromKey(*list, *key)
+//
+// Get the index of a key from the hashed list, through its hash index.
+//
+// Parameters:
+// list:	the hashed list from which index of key is required
+// key:		the key, whose index in the list is required
+//
+// Returns:
+// index:	index of key (emList_IndexNone for not found)
+//
+uint emList_GetHashFn(byte* key, byte key_size)
+{
+	uint hash = 0;
+	for(; key_size; key_size--, key++)
+		hash = (hash * 31) + *key;
+	// spread nearby keys apart, so that they do not form long probe runs
+	hash *= 40503U;
+	return hash ^ (hash >> 7);
+}
+
+uint emList_HashGetSlotFn(void* list_keys, byte key_size, emList_Index* hash, uint hash_mask, void* key)
+{
+	byte *keys = (byte*)list_keys, *ukey = (byte*)key;
+	emList_Index index;
+	uint slot = emList_GetHashFn(ukey, key_size) & hash_mask;
+	while((index = hash[slot]) != emList_IndexNone)
+	{
+		if(emList_IsElemEqualFn(keys + (key_size * index), ukey, key_size)) break;
+		slot = (slot + 1) & hash_mask;
+	}
+	return slot;
+}
+
+#define	emList_HashMask(list)	\
+	((((uint)(*(list)).Max) << 1) | 1)
+
+#define	emList_HashGetIndexFromKey(list, key)	\
+	((*(list)).Hash[emList_HashGetSlotFn((*(list)).Key, sizeof((*(list)).Key[0]), (*(list)).Hash, emList_HashMask(list), key)])
+
+#if emList_Shorthand >= 1
+#define	list_HashGetIndexFromKey	emList_HashGetIndexFromKey
+#endif
+
+#if	emList_Shorthand >= 2
+#define	lstHashGetIndexFromKey	emList_HashGetIndexFromKey
+#endif
+
+
+
+// Function:
+// HashAdd(*list, *key, *value)
+//
+// Add a key-value pair to the hashed list. If another key-value pair exists
+// with the same key, then it will be overwritten. If sufficient space is not
+// available, then the key-value pair will not be added.
+//
+// Parameters:
+// list:	the hashed list to the key-value pair is to be added
+// key:		the key to be added (expected to be unique)
+// value:	the value to be added to list along with key
+//
+// Returns:
+// status:	0 for success, 0xFF for full
+//
+byte emList_HashAddFn(void* list, void* list_keys, void* list_values, byte key_size, byte value_size, emList_Index* hash, void* key, void* value)
+{
+	emList_ByteByteMold256* lst = (emList_ByteByteMold256*)list;
+	uint slot = emList_HashGetSlotFn(list_keys, key_size, hash, (((uint)lst->Max) << 1) | 1, key);
+	emList_Index index = hash[slot];
+	if(index == emList_IndexNone)
+	{
+		if(lst->Count >= lst->Max) return 0xFF;	// list is full
+		index = lst->Count++;
+		hash[slot] = index;
+	}
+	memcpy((byte*)list_keys + (key_size * index), key, key_size);
+	memcpy((byte*)list_values + (value_size * index), value, value_size);
+	return 0;
+}
+
+#define	emList_HashAdd(list, key, value)	\
+	emList_HashAddFn(list, (*(list)).Key, (*(list)).Value, sizeof((*(list)).Key[0]), sizeof((*(list)).Value[0]), (*(list)).Hash, key, value)
+
+#if emList_Shorthand >= 1
+#define	list_HashAdd			emList_HashAdd
+#endif
+
+#if	emList_Shorthand >= 2
+#define	lstHashAdd				emList_HashAdd
+#endif
+
+
+
+// Function:
+// HashRemoveAt(*list, index)
+// HashRemove(*list, *key)
+//
+// Removes a key-value pair at specified index (index), or having the specified
+// key (key) from the hashed list. The last pair is moved into the place of the
+// removed pair (as with RemoveAtUnordered()), and the entries of the hash index
+// that follow the removed one are shifted back, so removal takes constant time on
+// average, but does not preserve the order of pairs. Removing a key that is not
+// in the list fails, and leaves the list unchanged.
+//
+// Parameters:
+// list:	the hashed list from which a key-value pair is to be removed
+// index:	index of the key-value pair to be removed
+// key:		key of the key-value pair to be removed
+//
+// Returns:
+// status:	0 for success, 0xFF for empty / unavailable
+//
+uint emList_HashGetSlotOfFn(void* list_keys, byte key_size, emList_Index* hash, uint hash_mask, emList_Index index)
+{
+	uint slot = emList_GetHashFn((byte*)list_keys + (key_size * index), key_size) & hash_mask;
+	while(hash[slot] != index)
+		slot = (slot + 1) & hash_mask;
+	return slot;
+}
+
+byte emList_HashRemoveAtFn(void* list, void* list_keys, void* list_values, byte key_size, byte value_size, emList_Index* hash, emList_Index index)
+{
+	emList_ByteByteMold256* lst = (emList_ByteByteMold256*)list;
+	uint hash_mask = (((uint)lst->Max) << 1) | 1, slot, next, home;
+	byte* keys = (byte*)list_keys;
+	if(index == emList_IndexNone || index >= lst->Count) return 0xFF;
+	slot = emList_HashGetSlotOfFn(list_keys, key_size, hash, hash_mask, index);
+	// shift back each following entry whose home slot is not after the free slot
+	for(next = (slot + 1) & hash_mask; hash[next] != emList_IndexNone; next = (next + 1) & hash_mask)
+	{
+		home = emList_GetHashFn(keys + (key_size * hash[next]), key_size) & hash_mask;
+		if(((next - home) & hash_mask) < ((next - slot) & hash_mask)) continue;
+		hash[slot] = hash[next];
+		slot = next;
+	}
+	hash[slot] = emList_IndexNone;
+	if(index != lst->Count - 1) hash[emList_HashGetSlotOfFn(list_keys, key_size, hash, hash_mask, lst->Count - 1)] = index;
+	return emList_RemoveAtUnorderedFn(list, list_keys, list_values, key_size, value_size, index);
+}
+
+#define	emList_HashRemoveAt(list, index)	\
+	emList_HashRemoveAtFn(list, (*(list)).Key, (*(list)).Value, sizeof((*(list)).Key[0]), sizeof((*(list)).Value[0]), (*(list)).Hash, index)
+
+#define	emList_HashRemove(list, key)	\
+	emList_HashRemoveAt(list, emList_HashGetIndexFromKey(list, key))
+
+#if emList_Shorthand >= 1
+#define	list_HashRemoveAt		emList_HashRemoveAt
+#define	list_HashRemove			emList_HashRemove
+#endif
+
+#if	emList_Shorthand >= 2
+#define	lstHashRemoveAt			emList_HashRemoveAt
+#define	lstHashRemove			emList_HashRemove
+#endif
+
+
+
 #endif
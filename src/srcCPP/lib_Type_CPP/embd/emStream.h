@@ -49,21 +49,63 @@
 
 
 
+// Select index width
+// 
+// The index width (8, 16 or 32 bits) is the size of the Front, Rear,
+// Count and Max fields of stream molds. It limits the size of a stream
+// to 256 bytes, 64 KB or 4 GB. The default is 8 bits, which keeps the
+// small footprint on AVR. The index width can be selected in the main
+// header file of embd library
+#ifndef	emStream_IndexWidth
+#define	emStream_IndexWidth	8
+#endif
+
+#if	emStream_IndexWidth == 32
+#define	emStream_Index		emType_Bits32
+#elif	emStream_IndexWidth == 16
+#define	emStream_Index		uint16
+#else
+#define	emStream_Index		byte
+#endif
+
+#if emStream_Shorthand >= 1
+#define	stream_Index			emStream_Index
+#endif
+
+#if	emStream_Shorthand >= 2
+#define	stmIndex				emStream_Index
+#endif
+
+
+
+// Select block copy size
+// 
+// Transfers of upto CopyMin bytes are copied byte by
+// byte, as calling a block copy costs more for them.
+#ifndef	emStream_CopyMin
+#define	emStream_CopyMin	16
+#endif
+
+
+
 // Stream Mold format
 // 
 // Streams can be created with different sizes. emStream_Mold8 has a size of 8 bytes,
 // emStream_Mold16 has 16 bytes size, and so on. The range is from 8 to 256 bytes (in
-// powers of 2). The default emStream_Mold has a size of 256 bytes. The size of streams
+// powers of 2). The default emStream_Mold has a size of 256 bytes. Larger streams can
+// be made with MoldMake(), upto the limit of the selected index width. The size of streams
 // must always be a power of 2. This fact is used to replace modulus operation, with the
-// and operation (which is very fast).
+// and operation (which is very fast). Tasks waiting to read from, or write to a stream
+// wait on its Event, which is signalled whenever data is read or written.
 // 
 #define	emStream_MoldMake(size)	\
 typedef struct _emStream_Mold##size	\
 {	\
-	byte	Front;	\
-	byte	Rear;	\
-	byte	Count;	\
-	byte	Max;	\
+	emStream_Index	Front;	\
+	emStream_Index	Rear;	\
+	emStream_Index	Count;	\
+	emStream_Index	Max;	\
+	emTask_Event	Event;	\
 	byte	Data[size];	\
 }emStream_Mold##size
 
@@ -103,12 +145,6 @@ emStream_MoldMake(256);
 
 
 
-// Internal Storage variables
-byte	emStream_LoopI = 0;
-
-
-
-
 // Function:
 // Init(*stream, size)
 // 
@@ -129,6 +165,7 @@ byte	emStream_LoopI = 0;
 		(*(stream)).Rear = 0;	\
 		(*(stream)).Count = 0;	\
 		(*(stream)).Max = (size) - 1;	\
+		emTask_EventInit(&(*(stream)).Event);	\
 	}while(0)
 
 #if emStream_Shorthand >= 1
@@ -144,7 +181,7 @@ byte	emStream_LoopI = 0;
 // Function:
 // Clear(*stream)
 // 
-// Clears a stream of all data.
+// Clears a stream of all data. Tasks waiting to write to the stream are woken up.
 // 
 // Parameters:
 // stream:	the stream to clear
@@ -157,6 +194,7 @@ byte	emStream_LoopI = 0;
 		(*(stream)).Front = 0;	\
 		(*(stream)).Rear = 0;	\
 		(*(stream)).Count = 0;	\
+		emTask_EventPostFn(&(*(stream)).Event);	\
 	}while(0)
 
 #if emStream_Shorthand >= 1
@@ -233,7 +271,15 @@ byte	emStream_LoopI = 0;
 // of ReadBytes(). ReadBytesInt() directly exits if sufficient bytes are
 // not available. If waiting in a task is not desirable then GetAvail()
 // can be used to check the number of bytes available in stream, and then
-// accordingly choose to read or do something else.
+// accordingly choose to read or do something else. ReadBytesInt() copies
+// the bytes in at most two blocks (before and after the wrap point), or byte
+// by byte if they are few (see CopyMin).
+// ReadBytes() reads as many bytes as are available each time the task
+// runs, and keeps the number of bytes read so far in the Cursor of the
+// task object, so several tasks can wait on different streams at once.
+// While waiting, the task is parked on the Event of the stream, which is
+// signalled by writes (ReadBytesInt() posts it instead). The stream, dst
+// and len must remain valid while the task waits.
 // 
 // Parameters:
 // stream:	the stream from which a set of bytes is to be read
@@ -243,50 +289,73 @@ byte	emStream_LoopI = 0;
 // Returns:
 // nothing
 //
+uint emStream_ReadBytesSomeFn(void* stream, byte* dst, uint len)
+{
+	emStream_Mold256* stm = (emStream_Mold256*)stream;
+	uint front = stm->Front, part = stm->Max + 1 - front, i;
+	if(len > emStream_GetAvail(stm)) len = emStream_GetAvail(stm);
+	if(part > len) part = len;
+	if(dst && len <= emStream_CopyMin)
+	{
+		for(i=0; i<len; i++)
+			dst[i] = stm->Data[(front + i) & stm->Max];
+	}
+	else if(dst)
+	{
+		memcpy(dst, stm->Data + front, part);
+		memcpy(dst + part, stm->Data, len - part);
+	}
+	stm->Front = (front + len) & stm->Max;
+	stm->Count -= len;
+	return len;
+}
+
+uint emStream_ReadBytesWakeFn(void* stream, byte* dst, uint len)
+{
+	len = emStream_ReadBytesSomeFn(stream, dst, len);
+	if(len) emTask_EventBroadcastFn(&((emStream_Mold256*)stream)->Event);
+	return len;
+}
+
+void emStream_ReadBytesIntFn(void* stream, byte* dst, uint len)
+{
+	if(emStream_GetAvail((emStream_Mold256*)stream) < len) return;
+	emStream_ReadBytesSomeFn(stream, dst, len);
+	emTask_EventPostFn(&((emStream_Mold256*)stream)->Event);
+}
+
 #define	emStream_ReadBytesIntDel(stream, len)	\
 	do{	\
 		if(emStream_GetAvail(stream) >= (len))	\
 		{	\
 			(*(stream)).Front = ((*(stream)).Front + (len)) & (*(stream)).Max;	\
 			(*(stream)).Count -= (len);	\
+			emTask_EventPostFn(&(*(stream)).Event);	\
 		}	\
 	}while(0)
 
 #define	emStream_ReadBytesIntDst(stream, dst, len)	\
-	do{	\
-		if(emStream_GetAvail(stream) >= (len))	\
-		{	\
-			for(emStream_LoopI = 0; emStream_LoopI < (len); emStream_LoopI++)	\
-			{	\
-				*(((byte*)(dst)) + emStream_LoopI) = (*(stream)).Data[(*(stream)).Front];	\
-				(*(stream)).Front = ((*(stream)).Front + 1) & (*(stream)).Max;	\
-			}	\
-			(*(stream)).Count -= (len);	\
-		}	\
-	}while(0)
+	emStream_ReadBytesIntFn(stream, (byte*)(dst), (uint)(len))
 
 #define	emStream_ReadBytesInt(...)	\
 	Macro(Macro3(__VA_ARGS__, emStream_ReadBytesIntDst, emStream_ReadBytesIntDel)(__VA_ARGS__))
 
 #define	emStream_ReadBytesDel(stream, len)	\
 	do{	\
-		for(emStream_LoopI = 0; emStream_LoopI < (len); emStream_LoopI++)	\
-		{	\
-			emTask_WaitWhile(emStream_GetAvail(stream) < 1, byte, emStream_LoopI);	\
-			(*(stream)).Front = ((*(stream)).Front + 1) & (*(stream)).Max;	\
-			(*(stream)).Count--;	\
-		}	\
+		(*emTask_Obj).Cursor = 0;	\
+		(*emTask_Obj).Line = __LINE__;	\
+		case __LINE__:	\
+		(*emTask_Obj).Cursor += emStream_ReadBytesWakeFn(stream, NULL, (uint)(len) - (*emTask_Obj).Cursor);	\
+		if((*emTask_Obj).Cursor < (uint)(len)) emTask_Block(&(*(stream)).Event);	\
 	}while(0)
 
 #define	emStream_ReadBytesDst(stream, dst, len)	\
 	do{	\
-		for(emStream_LoopI = 0; emStream_LoopI < (len); emStream_LoopI++)	\
-		{	\
-			emTask_WaitWhile(emStream_GetAvail(stream) < 1, byte, emStream_LoopI);	\
-			*(((byte*)(dst)) + emStream_LoopI) = (*(stream)).Data[(*(stream)).Front];	\
-			(*(stream)).Front = ((*(stream)).Front + 1) & (*(stream)).Max;	\
-			(*(stream)).Count--;	\
-		}	\
+		(*emTask_Obj).Cursor = 0;	\
+		(*emTask_Obj).Line = __LINE__;	\
+		case __LINE__:	\
+		(*emTask_Obj).Cursor += emStream_ReadBytesWakeFn(stream, ((byte*)(dst)) + (*emTask_Obj).Cursor, (uint)(len) - (*emTask_Obj).Cursor);	\
+		if((*emTask_Obj).Cursor < (uint)(len)) emTask_Block(&(*(stream)).Event);	\
 	}while(0)
 
 #define	emStream_ReadBytes(...)	\
@@ -332,25 +401,28 @@ byte	emStream_LoopI = 0;
 			*((byte*)(dst)) = (*(stream)).Data[(*(stream)).Front];	\
 			(*(stream)).Front = ((*(stream)).Front + 1) & (*(stream)).Max;	\
 			(*(stream)).Count--;	\
+			emTask_EventPostFn(&(*(stream)).Event);	\
 		}	\
 	}while(0)
 
 #define	emStream_ReadByteIntRet(stream)	\
 	({	\
-		emStream_ReadByteIntVal(stream, emType.Byte);	\
-		emType.Byte[0];	\
+		byte emStream_Value = 0;	\
+		emStream_ReadByteIntVal(stream, &emStream_Value);	\
+		emStream_Value;	\
 	})
 
 #define	emStream_ReadByteInt(...)	\
 	Macro(Macro2(__VA_ARGS__, emStream_ReadByteIntVal, emStream_ReadByteIntRet)(__VA_ARGS__))
 
 #define	emStream_ReadSbyteIntVal(stream, dst)	\
-	emStream_ReadSbyteIntVal(stream, dst)
+	emStream_ReadByteIntVal(stream, dst)
 
 #define	emStream_ReadSbyteIntRet(stream)	\
 	({	\
-		emStream_ReadSbyteIntVal(stream, emType.Sbyte);	\
-		emType.Sbyte[0];	\
+		sbyte emStream_Value = 0;	\
+		emStream_ReadSbyteIntVal(stream, &emStream_Value);	\
+		emStream_Value;	\
 	})
 
 #define	emStream_ReadSbyteInt(...)	\
@@ -358,8 +430,9 @@ byte	emStream_LoopI = 0;
 
 #define	emStream_ReadShortIntRet(stream)	\
 	({	\
-		emStream_ReadBytesInt(stream, emType.Short, 2);	\
-		emType.Short[0];	\
+		short emStream_Value = 0;	\
+		emStream_ReadBytesInt(stream, &emStream_Value, 2);	\
+		emStream_Value;	\
 	})
 
 #define	emStream_ReadShortIntVal(stream, dst)	\
@@ -373,8 +446,9 @@ byte	emStream_LoopI = 0;
 
 #define	emStream_ReadUshortIntRet(stream)	\
 	({	\
-		emStream_ReadBytesInt(stream, emType.Ushort, 2);	\
-		emType.Ushort[0];	\
+		ushort emStream_Value = 0;	\
+		emStream_ReadBytesInt(stream, &emStream_Value, 2);	\
+		emStream_Value;	\
 	})
 
 #define	emStream_ReadUshortInt(...)	\
@@ -382,8 +456,9 @@ byte	emStream_LoopI = 0;
 
 #define	emStream_ReadLongIntRet(stream)	\
 	({	\
-		emStream_ReadBytesInt(stream, emType.Long, 4);	\
-		emType.Long[0];	\
+		emType_Sbits32 emStream_Value = 0;	\
+		emStream_ReadBytesInt(stream, &emStream_Value, 4);	\
+		(long)emStream_Value;	\
 	})
 
 #define	emStream_ReadLongIntVal(stream, dst)	\
@@ -394,8 +469,9 @@ byte	emStream_LoopI = 0;
 
 #define	emStream_ReadUlongIntRet(stream)	\
 	({	\
-		emStream_ReadBytesInt(stream, emType.Ulong, 4);	\
-		emType.Ulong[0];	\
+		emType_Bits32 emStream_Value = 0;	\
+		emStream_ReadBytesInt(stream, &emStream_Value, 4);	\
+		(ulong)emStream_Value;	\
 	})
 
 #define	emStream_ReadUlongIntVal(stream, dst)	\
@@ -425,7 +501,7 @@ byte	emStream_LoopI = 0;
 #define	emStream_ReadUint32Int	\
 	emStream_ReadUlongInt
 
-#if embd_Platform == emdb_PlatformPC
+#if embd_Platform == embd_PlatformPC
 #define	emStream_ReadIntInt	\
 	emStream_ReadLongInt
 
@@ -441,8 +517,9 @@ byte	emStream_LoopI = 0;
 
 #define	emStream_ReadInt64IntRet(stream)	\
 	({	\
-		emStream_ReadBytesInt(stream, emType.Int64, 8);	\
-		emType.Int64[0];	\
+		int64 emStream_Value = 0;	\
+		emStream_ReadBytesInt(stream, &emStream_Value, 8);	\
+		emStream_Value;	\
 	})
 
 #define	emStream_ReadInt64IntVal(stream, dst)	\
@@ -453,8 +530,9 @@ byte	emStream_LoopI = 0;
 
 #define	emStream_ReadUint64IntRet(stream)	\
 	({	\
-		emStream_ReadBytesInt(stream, emType.Uint64, 8);	\
-		emType.Uint64[0];	\
+		uint64 emStream_Value = 0;	\
+		emStream_ReadBytesInt(stream, &emStream_Value, 8);	\
+		emStream_Value;	\
 	})
 
 #define	emStream_ReadUint64IntVal(stream, dst)	\
@@ -465,8 +543,9 @@ byte	emStream_LoopI = 0;
 
 #define	emStream_ReadFloatIntRet(stream)	\
 	({	\
-		emStream_ReadBytesInt(stream, emType.Float, 4);	\
-		emType.Float[0];	\
+		float emStream_Value = 0;	\
+		emStream_ReadBytesInt(stream, &emStream_Value, 4);	\
+		emStream_Value;	\
 	})
 
 #define	emStream_ReadFloatIntVal(stream, dst)	\
@@ -477,8 +556,9 @@ byte	emStream_LoopI = 0;
 
 #define	emStream_ReadDoubleIntRet(stream)	\
 	({	\
-		emStream_ReadBytesInt(stream, emType.Double, 8);	\
-		emType.Double[0];	\
+		double emStream_Value = 0;	\
+		emStream_ReadBytesInt(stream, &emStream_Value, 8);	\
+		emStream_Value;	\
 	})
 
 #define	emStream_ReadDoubleIntVal(stream, dst)	\
@@ -489,28 +569,33 @@ byte	emStream_LoopI = 0;
 
 #define	emStream_ReadByteVal(stream, dst)	\
 	do{	\
-		emTask_WaitWhile(emStream_GetAvail(stream) < 1);	\
+		emTask_WaitEventWhile(&(*(stream)).Event, emStream_GetAvail(stream) < 1);	\
 		*((byte*)(dst)) = (*(stream)).Data[(*(stream)).Front];	\
 		(*(stream)).Front = ((*(stream)).Front + 1) & (*(stream)).Max;	\
 		(*(stream)).Count--;	\
+		emTask_EventBroadcastFn(&(*(stream)).Event);	\
 	}while(0)
 
 #define	emStream_ReadByteRet(stream)	\
 	({	\
-		emStream_ReadByteVal(stream, emType.Byte);	\
-		emType.Byte[0];	\
+		emTask_WaitEventWhile(&(*(stream)).Event, emStream_GetAvail(stream) < 1);	\
+		byte emStream_Value;	\
+		emStream_ReadBytesWakeFn(stream, (byte*)&emStream_Value, 1);	\
+		emStream_Value;	\
 	})
 
 #define	emStream_ReadByte(...)	\
 	Macro(Macro2(__VA_ARGS__, emStream_ReadByteVal, emStream_ReadByteRet)(__VA_ARGS__))
 
 #define	emStream_ReadSbyteVal(stream, dst)	\
-	emType_ReadByteVal(stream, dst)
+	emStream_ReadByteVal(stream, dst)
 
 #define	emStream_ReadSbyteRet(stream)	\
 	({	\
-		emStream_ReadSbyteVal(stream, emType.Sbyte);	\
-		emType.Sbyte[0];	\
+		emTask_WaitEventWhile(&(*(stream)).Event, emStream_GetAvail(stream) < 1);	\
+		sbyte emStream_Value;	\
+		emStream_ReadBytesWakeFn(stream, (byte*)&emStream_Value, 1);	\
+		emStream_Value;	\
 	})
 
 #define	emStream_ReadSbyte(...)	\
@@ -518,8 +603,10 @@ byte	emStream_LoopI = 0;
 
 #define	emStream_ReadShortRet(stream)	\
 	({	\
-		emStream_ReadBytes(stream, emType.Short, 2);	\
-		emType.Short[0];	\
+		emTask_WaitEventWhile(&(*(stream)).Event, emStream_GetAvail(stream) < 2);	\
+		short emStream_Value;	\
+		emStream_ReadBytesWakeFn(stream, (byte*)&emStream_Value, 2);	\
+		emStream_Value;	\
 	})
 
 #define	emStream_ReadShortVal(stream, dst)	\
@@ -530,8 +617,10 @@ byte	emStream_LoopI = 0;
 
 #define	emStream_ReadUshortRet(stream)	\
 	({	\
-		emStream_ReadBytes(stream, emType.Ushort, 2);	\
-		emType.Ushort[0];	\
+		emTask_WaitEventWhile(&(*(stream)).Event, emStream_GetAvail(stream) < 2);	\
+		ushort emStream_Value;	\
+		emStream_ReadBytesWakeFn(stream, (byte*)&emStream_Value, 2);	\
+		emStream_Value;	\
 	})
 
 #define	emStream_ReadUshortVal(stream, dst)	\
@@ -542,8 +631,10 @@ byte	emStream_LoopI = 0;
 
 #define	emStream_ReadLongRet(stream)	\
 	({	\
-		emStream_ReadBytes(stream, emType.Long, 4);	\
-		emType.Long[0];	\
+		emTask_WaitEventWhile(&(*(stream)).Event, emStream_GetAvail(stream) < 4);	\
+		emType_Sbits32 emStream_Value = 0;	\
+		emStream_ReadBytesWakeFn(stream, (byte*)&emStream_Value, 4);	\
+		(long)emStream_Value;	\
 	})
 
 #define	emStream_ReadLongVal(stream, dst)	\
@@ -554,8 +645,10 @@ byte	emStream_LoopI = 0;
 
 #define	emStream_ReadUlongRet(stream)	\
 	({	\
-		emStream_ReadBytes(stream, emType.Ulong, 4);	\
-		emType.Ulong[0];	\
+		emTask_WaitEventWhile(&(*(stream)).Event, emStream_GetAvail(stream) < 4);	\
+		emType_Bits32 emStream_Value = 0;	\
+		emStream_ReadBytesWakeFn(stream, (byte*)&emStream_Value, 4);	\
+		(ulong)emStream_Value;	\
 	})
 
 #define	emStream_ReadUlongVal(stream, dst)	\
@@ -585,7 +678,7 @@ byte	emStream_LoopI = 0;
 #define	emStream_ReadUint32	\
 	emStream_ReadUlong
 
-#if embd_Platform == emdb_PlatformPC
+#if embd_Platform == embd_PlatformPC
 #define	emStream_ReadInt	\
 	emStream_ReadLong
 
@@ -601,8 +694,10 @@ byte	emStream_LoopI = 0;
 
 #define	emStream_ReadInt64Ret(stream)	\
 	({	\
-		emStream_ReadBytes(stream, emType.Int64, 8);	\
-		emType.Int64[0];	\
+		emTask_WaitEventWhile(&(*(stream)).Event, emStream_GetAvail(stream) < 8);	\
+		int64 emStream_Value;	\
+		emStream_ReadBytesWakeFn(stream, (byte*)&emStream_Value, 8);	\
+		emStream_Value;	\
 	})
 
 #define	emStream_ReadInt64Val(stream, dst)	\
@@ -613,8 +708,10 @@ byte	emStream_LoopI = 0;
 
 #define	emStream_ReadUint64Ret(stream)	\
 	({	\
-		emStream_ReadBytes(stream, emType.Uint64, 8);	\
-		emType.Uint64[0];	\
+		emTask_WaitEventWhile(&(*(stream)).Event, emStream_GetAvail(stream) < 8);	\
+		uint64 emStream_Value;	\
+		emStream_ReadBytesWakeFn(stream, (byte*)&emStream_Value, 8);	\
+		emStream_Value;	\
 	})
 
 #define	emStream_ReadUint64Val(stream, dst)	\
@@ -625,8 +722,10 @@ byte	emStream_LoopI = 0;
 
 #define	emStream_ReadFloatRet(stream)	\
 	({	\
-		emStream_ReadBytes(stream, emType.Float, 4);	\
-		emType.Float[0];	\
+		emTask_WaitEventWhile(&(*(stream)).Event, emStream_GetAvail(stream) < 4);	\
+		float emStream_Value;	\
+		emStream_ReadBytesWakeFn(stream, (byte*)&emStream_Value, 4);	\
+		emStream_Value;	\
 	})
 
 #define	emStream_ReadFloatVal(stream, dst)	\
@@ -637,8 +736,10 @@ byte	emStream_LoopI = 0;
 
 #define	emStream_ReadDoubleRet(stream)	\
 	({	\
-		emStream_ReadBytes(stream, emType.Double, 8);	\
-		emType.Double[0];	\
+		emTask_WaitEventWhile(&(*(stream)).Event, emStream_GetAvail(stream) < 8);	\
+		double emStream_Value;	\
+		emStream_ReadBytesWakeFn(stream, (byte*)&emStream_Value, 8);	\
+		emStream_Value;	\
 	})
 
 #define	emStream_ReadDoubleVal(stream, dst)	\
@@ -784,7 +885,14 @@ byte	emStream_LoopI = 0;
 // check the amount of free space in bytes available in stream, and then accordingly
 // choose to write or do something else. When writing to a stream from inside an
 // interrupt, use WriteBytesInt(), instead of WriteBytes(). WriteBytesInt() directly
-// exits if sufficient bytes are not free in the stream.
+// exits if sufficient bytes are not free in the stream, and otherwise copies the
+// bytes in at most two blocks (before and after the wrap point), or byte by byte
+// if they are few (see CopyMin). WriteBytes()
+// writes as many bytes as there is space for each time the task runs, and keeps
+// the number of bytes written so far in the Cursor of the task object. While
+// waiting, the task is parked on the Event of the stream, which is signalled by
+// reads (WriteBytesInt() posts it instead). The stream, src and len must remain
+// valid while the task waits.
 // 
 // Parameters:
 // stream:	the stream to which a set of bytes is to be written
@@ -794,26 +902,51 @@ byte	emStream_LoopI = 0;
 // Returns:
 // nothing
 //
+uint emStream_WriteBytesSomeFn(void* stream, byte* src, uint len)
+{
+	emStream_Mold256* stm = (emStream_Mold256*)stream;
+	uint rear = stm->Rear, part = stm->Max + 1 - rear, free = (uint)emStream_GetFree(stm), i;
+	if(len > free) len = free;
+	if(part > len) part = len;
+	if(len <= emStream_CopyMin)
+	{
+		for(i=0; i<len; i++)
+			stm->Data[(rear + i) & stm->Max] = src[i];
+	}
+	else
+	{
+		memcpy(stm->Data + rear, src, part);
+		memcpy(stm->Data, src + part, len - part);
+	}
+	stm->Rear = (rear + len) & stm->Max;
+	stm->Count += len;
+	return len;
+}
+
+uint emStream_WriteBytesWakeFn(void* stream, byte* src, uint len)
+{
+	len = emStream_WriteBytesSomeFn(stream, src, len);
+	if(len) emTask_EventBroadcastFn(&((emStream_Mold256*)stream)->Event);
+	return len;
+}
+
+void emStream_WriteBytesIntFn(void* stream, byte* src, uint len)
+{
+	if((uint)emStream_GetFree((emStream_Mold256*)stream) < len) return;
+	emStream_WriteBytesSomeFn(stream, src, len);
+	emTask_EventPostFn(&((emStream_Mold256*)stream)->Event);
+}
+
 #define	emStream_WriteBytesInt(stream, src, len)	\
-	do{	\
-		if(emStream_GetFree(stream) < (len)) break;	\
-		for(emStream_LoopI = 0; emStream_LoopI < (len); emStream_LoopI++)	\
-		{	\
-			(*(stream)).Data[(*(stream)).Rear] = *(((byte*)(src)) + emStream_LoopI);	\
-			(*(stream)).Rear = ((*(stream)).Rear + 1) & (*(stream)).Max;	\
-		}	\
-		(*(stream)).Count += (len);	\
-	}while(0)
+	emStream_WriteBytesIntFn(stream, (byte*)(src), (uint)(len))
 
 #define	emStream_WriteBytes(stream, src, len)	\
 	do{	\
-		for(emStream_LoopI = 0; emStream_LoopI < (len); emStream_LoopI++)	\
-		{	\
-			emTask_WaitWhile(emStream_GetFree(stream) < 1, byte, emStream_LoopI);	\
-			(*(stream)).Data[(*(stream)).Rear] = *(((byte*)(src)) + emStream_LoopI);	\
-			(*(stream)).Rear = ((*(stream)).Rear + 1) & (*(stream)).Max;	\
-			(*(stream)).Count++;	\
-		}	\
+		(*emTask_Obj).Cursor = 0;	\
+		(*emTask_Obj).Line = __LINE__;	\
+		case __LINE__:	\
+		(*emTask_Obj).Cursor += emStream_WriteBytesWakeFn(stream, ((byte*)(src)) + (*emTask_Obj).Cursor, (uint)(len) - (*emTask_Obj).Cursor);	\
+		if((*emTask_Obj).Cursor < (uint)(len)) emTask_Block(&(*(stream)).Event);	\
 	}while(0)
 
 #if emStream_Shorthand >= 1
@@ -853,6 +986,7 @@ byte	emStream_LoopI = 0;
 			(*(stream)).Data[(*(stream)).Rear] = (value);	\
 			(*(stream)).Rear = ((*(stream)).Rear + 1) & (*(stream)).Max;	\
 			(*(stream)).Count++;	\
+			emTask_EventPostFn(&(*(stream)).Event);	\
 		}	\
 	}while(0)
 
@@ -863,31 +997,32 @@ byte	emStream_LoopI = 0;
 			(*(stream)).Data[(*(stream)).Rear] = (byte)(value);	\
 			(*(stream)).Rear = ((*(stream)).Rear + 1) & (*(stream)).Max;	\
 			(*(stream)).Count++;	\
+			emTask_EventPostFn(&(*(stream)).Event);	\
 		}	\
 	}while(0)
 
 #define	emStream_WriteShortInt(stream, value)	\
 	do{	\
-	emType.Short[0] = (value);	\
-	emStream_WriteBytesInt(stream, emType.Short, 2);	\
+	short emStream_Value = (value);	\
+	emStream_WriteBytesInt(stream, &emStream_Value, 2);	\
 	}while(0)
 
 #define	emStream_WriteUshortInt(stream, value)	\
 	do{	\
-	emType.Ushort[0] = (value);	\
-	emStream_WriteBytesInt(stream, emType.Ushort, 2);	\
+	ushort emStream_Value = (value);	\
+	emStream_WriteBytesInt(stream, &emStream_Value, 2);	\
 	}while(0)
 
 #define	emStream_WriteLongInt(stream, value)	\
 	do{	\
-	emType.Long[0] = (value);	\
-	emStream_WriteBytesInt(stream, emType.Long, 4);	\
+	emType_Sbits32 emStream_Value = (emType_Sbits32)(value);	\
+	emStream_WriteBytesInt(stream, &emStream_Value, 4);	\
 	}while(0)
 
-#define	emStream_WriteUlongInt(stream, ulong_value)	\
+#define	emStream_WriteUlongInt(stream, value)	\
 	do{	\
-	emType.Ulong[0] = (value);	\
-	emStream_WriteBytesInt(stream, emType.Ulong, 4);	\
+	emType_Bits32 emStream_Value = (emType_Bits32)(value);	\
+	emStream_WriteBytesInt(stream, &emStream_Value, 4);	\
 	}while(0)
 
 #define	emStream_WriteCharInt	\
@@ -927,66 +1062,72 @@ byte	emStream_LoopI = 0;
 
 #define	emStream_WriteInt64Int(stream, value)	\
 	do{	\
-	emType.Int64[0] = (value);	\
-	emStream_WriteBytesInt(stream, emType.Int64, 8);	\
+	int64 emStream_Value = (value);	\
+	emStream_WriteBytesInt(stream, &emStream_Value, 8);	\
 	}while(0)
 
 #define	emStream_WriteUint64Int(stream, value)	\
 	do{	\
-	emType.Uint64[0] = (value);	\
-	emStream_WriteBytesInt(stream, emType.Uint64, 8);	\
+	uint64 emStream_Value = (value);	\
+	emStream_WriteBytesInt(stream, &emStream_Value, 8);	\
 	}while(0)
 
 #define	emStream_WriteFloatInt(stream, value)	\
 	do{	\
-	emType.Float[0] = (value);	\
-	emStream_WriteBytesInt(stream, emType.Float, 4);	\
+	float emStream_Value = (value);	\
+	emStream_WriteBytesInt(stream, &emStream_Value, 4);	\
 	}while(0)
 
 #define	emStream_WriteDoubleInt(stream, value)	\
 	do{	\
-	emType.Double[0] = (value);	\
-	emStream_WriteBytesInt(stream, emType.Double, 8);	\
+	double emStream_Value = (value);	\
+	emStream_WriteBytesInt(stream, &emStream_Value, 8);	\
 	}while(0)
 
 #define	emStream_WriteByte(stream, value)	\
 	do{	\
-		emTask_WaitWhile(emStream_GetFree(stream) < 1);	\
+		emTask_WaitEventWhile(&(*(stream)).Event, emStream_GetFree(stream) < 1);	\
 		(*(stream)).Data[(*(stream)).Rear] = (value);	\
 		(*(stream)).Rear = ((*(stream)).Rear + 1) & (*(stream)).Max;	\
 		(*(stream)).Count++;	\
+		emTask_EventBroadcastFn(&(*(stream)).Event);	\
 	}while(0)
 
 #define	emStream_WriteSbyte(stream, value)	\
 	do{	\
-		emTask_WaitWhile(emStream_GetFree(stream) < 1);	\
+		emTask_WaitEventWhile(&(*(stream)).Event, emStream_GetFree(stream) < 1);	\
 		(*(stream)).Data[(*(stream)).Rear] = (byte)(value);	\
 		(*(stream)).Rear = ((*(stream)).Rear + 1) & (*(stream)).Max;	\
 		(*(stream)).Count++;	\
+		emTask_EventBroadcastFn(&(*(stream)).Event);	\
 	}while(0)
 
 #define	emStream_WriteShort(stream, value)	\
 	do{	\
-	emType.Short[0] = (value);	\
-	emStream_WriteBytes(stream, emType.Short, 2);	\
+	emTask_WaitEventWhile(&(*(stream)).Event, emStream_GetFree(stream) < 2);	\
+	short emStream_Value = (value);	\
+	emStream_WriteBytesWakeFn(stream, (byte*)&emStream_Value, 2);	\
 	}while(0)
 
 #define	emStream_WriteUshort(stream, value)	\
 	do{	\
-	emType.Ushort[0] = (value);	\
-	emStream_WriteBytes(stream, emType.Ushort, 2);	\
+	emTask_WaitEventWhile(&(*(stream)).Event, emStream_GetFree(stream) < 2);	\
+	ushort emStream_Value = (value);	\
+	emStream_WriteBytesWakeFn(stream, (byte*)&emStream_Value, 2);	\
 	}while(0)
 
 #define	emStream_WriteLong(stream, value)	\
 	do{	\
-	emType.Long[0] = (value);	\
-	emStream_WriteBytes(stream, emType.Long, 4);	\
+	emTask_WaitEventWhile(&(*(stream)).Event, emStream_GetFree(stream) < 4);	\
+	emType_Sbits32 emStream_Value = (emType_Sbits32)(value);	\
+	emStream_WriteBytesWakeFn(stream, (byte*)&emStream_Value, 4);	\
 	}while(0)
 
 #define	emStream_WriteUlong(stream, value)	\
 	do{	\
-	emType.Ulong[0] = (value);	\
-	emStream_WriteBytes(stream, emType.Ulong, 4);	\
+	emTask_WaitEventWhile(&(*(stream)).Event, emStream_GetFree(stream) < 4);	\
+	emType_Bits32 emStream_Value = (emType_Bits32)(value);	\
+	emStream_WriteBytesWakeFn(stream, (byte*)&emStream_Value, 4);	\
 	}while(0)
 
 #define	emStream_WriteChar	\
@@ -1026,26 +1167,30 @@ byte	emStream_LoopI = 0;
 
 #define	emStream_WriteInt64(stream, value)	\
 	do{	\
-	emType.Int64[0] = (value);	\
-	emStream_WriteBytes(stream, emType.Int64, 8);	\
+	emTask_WaitEventWhile(&(*(stream)).Event, emStream_GetFree(stream) < 8);	\
+	int64 emStream_Value = (value);	\
+	emStream_WriteBytesWakeFn(stream, (byte*)&emStream_Value, 8);	\
 	}while(0)
 
 #define	emStream_WriteUint64(stream, value)	\
 	do{	\
-	emType.Uint64[0] = (value);	\
-	emStream_WriteBytes(stream, emType.Uint64, 8);	\
+	emTask_WaitEventWhile(&(*(stream)).Event, emStream_GetFree(stream) < 8);	\
+	uint64 emStream_Value = (value);	\
+	emStream_WriteBytesWakeFn(stream, (byte*)&emStream_Value, 8);	\
 	}while(0)
 
 #define	emStream_WriteFloat(stream, value)	\
 	do{	\
-	emType.Float[0] = (value);	\
-	emStream_WriteBytes(stream, emType.Float, 4);	\
+	emTask_WaitEventWhile(&(*(stream)).Event, emStream_GetFree(stream) < 4);	\
+	float emStream_Value = (value);	\
+	emStream_WriteBytesWakeFn(stream, (byte*)&emStream_Value, 4);	\
 	}while(0)
 
 #define	emStream_WriteDouble(stream, value)	\
 	do{	\
-	emType.Double[0] = (value);	\
-	emStream_WriteBytes(stream, emType.Double, 8);	\
+	emTask_WaitEventWhile(&(*(stream)).Event, emStream_GetFree(stream) < 8);	\
+	double emStream_Value = (value);	\
+	emStream_WriteBytesWakeFn(stream, (byte*)&emStream_Value, 8);	\
 	}while(0)
 
 #if emStream_Shorthand >= 1
@@ -1132,4 +1277,744 @@ byte	emStream_LoopI = 0;
 
 
 
+// Single-Producer Single-Consumer Stream Mold format
+// 
+// An SPSC stream can be written by one thread (or interrupt), and read by another
+// thread at the same time. It has no shared Count field: the producer only writes
+// Rear, the consumer only writes Front, and each side reads the other's index with
+// acquire ordering (refreshing a cached copy only when it runs short). On PC, the
+// producer and consumer fields are kept in separate cache lines. One byte is kept
+// unused, so an SPSC stream of size bytes can hold upto size - 1 bytes. The size
+// must be a power of 2. SPSC streams must be used only through Spsc<function_name>().
+// 
+#if embd_Platform == embd_PlatformPC
+#define	emStream_SpscMoldMake(size)	\
+typedef struct _emStream_SpscMold##size	\
+{	\
+	emStream_Index	Max;	\
+	byte			Pad0[emType_CacheLine - sizeof(emStream_Index)];	\
+	emStream_Index	Rear;	\
+	emStream_Index	FrontCache;	\
+	byte			Pad1[emType_CacheLine - 2 * sizeof(emStream_Index)];	\
+	emStream_Index	Front;	\
+	emStream_Index	RearCache;	\
+	byte			Pad2[emType_CacheLine - 2 * sizeof(emStream_Index)];	\
+	byte			Data[size];	\
+}emStream_SpscMold##size
+#else
+#define	emStream_SpscMoldMake(size)	\
+typedef struct _emStream_SpscMold##size	\
+{	\
+	emStream_Index	Max;	\
+	emStream_Index	Rear;	\
+	emStream_Index	FrontCache;	\
+	emStream_Index	Front;	\
+	emStream_Index	RearCache;	\
+	byte			Data[size];	\
+}emStream_SpscMold##size
+#endif
+
+emStream_SpscMoldMake(256);
+
+#define	emStream_SpscMold		emStream_SpscMold256
+
+#if emStream_Shorthand >= 1
+#define	stream_SpscMoldMake		emStream_SpscMoldMake
+#define	stream_SpscMold256		emStream_SpscMold256
+#define	stream_SpscMold			emStream_SpscMold
+#endif
+
+#if	emStream_Shorthand >= 2
+#define	stmSpscMoldMake			emStream_SpscMoldMake
+#define	stmSpscMold256			emStream_SpscMold256
+#define	stmSpscMold				emStream_SpscMold
+#endif
+
+
+
+// Function:
+// SpscInit(*stream, size)
+// 
+// Initializes an SPSC stream before use (before it is shared).
+// 
+// Parameters:
+// stream:	the SPSC stream to initialize
+// size:	size of the stream to be initialized
+// 
+// Returns:
+// nothing
+//
+#define	emStream_SpscInit(stream, size)	\
+	do{	\
+		(*(stream)).Max = (size) - 1;	\
+		(*(stream)).Rear = 0;	\
+		(*(stream)).FrontCache = 0;	\
+		(*(stream)).Front = 0;	\
+		(*(stream)).RearCache = 0;	\
+	}while(0)
+
+#if emStream_Shorthand >= 1
+#define	stream_SpscInit			emStream_SpscInit
+#endif
+
+#if	emStream_Shorthand >= 2
+#define	stmSpscInit				emStream_SpscInit
+#endif
+
+
+
+// Function:
+// SpscGetAvail(*stream)
+// SpscGetFree(*stream)
+// 
+// Gives the number of bytes available to read (to be used by the consumer),
+// or the amount of free space in bytes (to be used by the producer) in an
+// SPSC stream.
+// 
+// Parameters:
+// stream:	the SPSC stream
+// 
+// Returns:
+// bytes_avail:	number of available bytes in stream
+// bytes_free:	amount of free space in stream (bytes)
+//
+#define	emStream_SpscGetAvail(stream)	\
+	((emStream_Index)(emType_LoadAcquire((*(stream)).Rear) - (*(stream)).Front) & (*(stream)).Max)
+
+#define	emStream_SpscGetFree(stream)	\
+	((emStream_Index)(emType_LoadAcquire((*(stream)).Front) - (*(stream)).Rear - 1) & (*(stream)).Max)
+
+#if emStream_Shorthand >= 1
+#define	stream_SpscGetAvail		emStream_SpscGetAvail
+#define	stream_SpscGetFree		emStream_SpscGetFree
+#endif
+
+#if	emStream_Shorthand >= 2
+#define	stmSpscGetAvail			emStream_SpscGetAvail
+#define	stmSpscGetFree			emStream_SpscGetFree
+#endif
+
+
+
+// Function:
+// SpscWriteBytes(*stream, *src, len)
+// SpscReadBytes(*stream, *dst, len)
+// 
+// Writes a set of bytes to (producer), or reads a set of bytes from (consumer)
+// an SPSC stream. The bytes are copied in at most two blocks, and then the
+// new Rear / Front is published with release ordering. If the stream does
+// not have sufficient free space / bytes available, nothing is transferred
+// and the call returns immediately (it never blocks).
+// 
+// Parameters:
+// stream:	the SPSC stream
+// src:		the address of bytes to be written
+// dst:		the address where the read bytes are to be stored
+// len:		number of bytes to be written / read
+// 
+// Returns:
+// status:	0 for success, 0xFF for insufficient free space / bytes
+//
+byte emStream_SpscWriteBytesFn(void* stream, byte* src, uint len)
+{
+	emStream_SpscMold256* stm = (emStream_SpscMold256*)stream;
+	uint max = stm->Max, rear = stm->Rear, part;
+	if(((stm->FrontCache - rear - 1) & max) < len)
+	{
+		stm->FrontCache = emType_LoadAcquire(stm->Front);
+		if(((stm->FrontCache - rear - 1) & max) < len) return 0xFF;
+	}
+	part = max + 1 - rear;
+	if(part > len) part = len;
+	memcpy(stm->Data + rear, src, part);
+	memcpy(stm->Data, src + part, len - part);
+	emType_StoreRelease(stm->Rear, (emStream_Index)((rear + len) & max));
+	return 0;
+}
+
+byte emStream_SpscReadBytesFn(void* stream, byte* dst, uint len)
+{
+	emStream_SpscMold256* stm = (emStream_SpscMold256*)stream;
+	uint max = stm->Max, front = stm->Front, part;
+	if(((stm->RearCache - front) & max) < len)
+	{
+		stm->RearCache = emType_LoadAcquire(stm->Rear);
+		if(((stm->RearCache - front) & max) < len) return 0xFF;
+	}
+	part = max + 1 - front;
+	if(part > len) part = len;
+	memcpy(dst, stm->Data + front, part);
+	memcpy(dst + part, stm->Data, len - part);
+	emType_StoreRelease(stm->Front, (emStream_Index)((front + len) & max));
+	return 0;
+}
+
+#define	emStream_SpscWriteBytes(stream, src, len)	\
+	emStream_SpscWriteBytesFn(stream, (byte*)(src), (uint)(len))
+
+#define	emStream_SpscReadBytes(stream, dst, len)	\
+	emStream_SpscReadBytesFn(stream, (byte*)(dst), (uint)(len))
+
+#if emStream_Shorthand >= 1
+#define	stream_SpscWriteBytes	emStream_SpscWriteBytes
+#define	stream_SpscReadBytes	emStream_SpscReadBytes
+#endif
+
+#if	emStream_Shorthand >= 2
+#define	stmSpscWriteBytes		emStream_SpscWriteBytes
+#define	stmSpscReadBytes		emStream_SpscReadBytes
+#endif
+
+
+
+// Multi-Producer Multi-Consumer Stream Mold format (PC only)
+// 
+// An MPMC stream is a bounded ring that can be written by several threads and read by
+// several threads at the same time. Each byte cell has a sequence number (Seq), which
+// tells whether the cell is free or filled for the current lap of the ring (based on the
+// bounded queue of Dmitry Vyukov). A producer (or consumer) checks that all the cells it
+// needs are ready, and then claims them all with a single compare-and-swap on Rear (or
+// Front). Rear and Front are positions that keep increasing (they are masked with Max only
+// for indexing), and are kept in separate cache lines. The size must be a power of 2.
+// MPMC streams must be used only through Mpmc<function_name>(). A multi-byte value written
+// in one call is read back whole only if consumers read it with the same size.
+// 
+#if embd_Platform == embd_PlatformPC
+#define	emStream_MpmcMoldMake(size)	\
+typedef struct _emStream_MpmcMold##size	\
+{	\
+	emType_Bits32	Max;	\
+	byte			Pad0[emType_CacheLine - sizeof(emType_Bits32)];	\
+	emType_Bits32	Rear;	\
+	byte			Pad1[emType_CacheLine - sizeof(emType_Bits32)];	\
+	emType_Bits32	Front;	\
+	byte			Pad2[emType_CacheLine - sizeof(emType_Bits32)];	\
+	emType_Bits32	Seq[size];	\
+	byte			Data[size];	\
+}emStream_MpmcMold##size
+
+emStream_MpmcMoldMake(256);
+
+#define	emStream_MpmcMold		emStream_MpmcMold256
+
+#if emStream_Shorthand >= 1
+#define	stream_MpmcMoldMake		emStream_MpmcMoldMake
+#define	stream_MpmcMold256		emStream_MpmcMold256
+#define	stream_MpmcMold			emStream_MpmcMold
+#endif
+
+#if	emStream_Shorthand >= 2
+#define	stmMpmcMoldMake			emStream_MpmcMoldMake
+#define	stmMpmcMold256			emStream_MpmcMold256
+#define	stmMpmcMold				emStream_MpmcMold
+#endif
+
+
+
+// Function:
+// MpmcInit(*stream, size)
+// 
+// Initializes an MPMC stream before use (before it is shared).
+// 
+// Parameters:
+// stream:	the MPMC stream to initialize
+// size:	size of the stream to be initialized
+// 
+// Returns:
+// nothing
+//
+void emStream_MpmcInitFn(void* stream, uint size)
+{
+	emStream_MpmcMold256* stm = (emStream_MpmcMold256*)stream;
+	uint i;
+	stm->Max = size - 1;
+	stm->Rear = 0;
+	stm->Front = 0;
+	for(i=0; i<size; i++)
+		stm->Seq[i] = i;
+}
+
+#define	emStream_MpmcInit(stream, size)	\
+	emStream_MpmcInitFn(stream, (uint)(size))
+
+#if emStream_Shorthand >= 1
+#define	stream_MpmcInit			emStream_MpmcInit
+#endif
+
+#if	emStream_Shorthand >= 2
+#define	stmMpmcInit				emStream_MpmcInit
+#endif
+
+
+
+// Function:
+// MpmcGetAvail(*stream)
+// MpmcGetFree(*stream)
+// 
+// Gives the number of bytes claimed by producers but not yet by consumers,
+// or the amount of free space in bytes in an MPMC stream. Since other threads
+// may be using the stream, the value is only a hint.
+// 
+// Parameters:
+// stream:	the MPMC stream
+// 
+// Returns:
+// bytes_avail:	number of available bytes in stream
+// bytes_free:	amount of free space in stream (bytes)
+//
+#define	emStream_MpmcGetAvail(stream)	\
+	((emType_Bits32)(emType_LoadAcquire((*(stream)).Rear) - emType_LoadAcquire((*(stream)).Front)))
+
+#define	emStream_MpmcGetFree(stream)	\
+	((*(stream)).Max + 1 - emStream_MpmcGetAvail(stream))
+
+#if emStream_Shorthand >= 1
+#define	stream_MpmcGetAvail		emStream_MpmcGetAvail
+#define	stream_MpmcGetFree		emStream_MpmcGetFree
+#endif
+
+#if	emStream_Shorthand >= 2
+#define	stmMpmcGetAvail			emStream_MpmcGetAvail
+#define	stmMpmcGetFree			emStream_MpmcGetFree
+#endif
+
+
+
+// Function:
+// MpmcWriteBytes(*stream, *src, len)
+// MpmcReadBytes(*stream, *dst, len)
+// 
+// Writes a batch of bytes to, or reads a batch of bytes from an MPMC stream.
+// All the cells of the batch are claimed with one compare-and-swap, copied
+// in at most two blocks, and then handed over by updating their sequence
+// numbers (with release ordering). If the stream does not have sufficient
+// free space / bytes available, nothing is transferred and the call returns
+// immediately (it never blocks).
+// 
+// Parameters:
+// stream:	the MPMC stream
+// src:		the address of bytes to be written
+// dst:		the address where the read bytes are to be stored
+// len:		number of bytes to be written / read
+// 
+// Returns:
+// status:	0 for success, 0xFF for insufficient free space / bytes
+//
+byte emStream_MpmcClaimFn(emType_Bits32* pos_var, emType_Bits32* seq, emType_Bits32 max, uint len, emType_Bits32 ready, emType_Bits32* claim)
+{
+	emType_Bits32 pos, i;
+	int diff;
+	if(len == 0 || len > max + 1) return 0xFF;
+	while(TRUE)
+	{
+		pos = emType_LoadAcquire(*pos_var);
+		for(i=0, diff=0; i<len; i++)
+		{
+			diff = (int)(emType_LoadAcquire(seq[(pos + i) & max]) - (pos + i + ready));
+			if(diff) break;
+		}
+		if(diff < 0) return 0xFF;	// not ready (full / empty)
+		if(!diff && emType_CompareSwap(*pos_var, pos, pos + len))
+		{
+			*claim = pos;
+			return 0;
+		}
+	}
+}
+
+byte emStream_MpmcWriteBytesFn(void* stream, byte* src, uint len)
+{
+	emStream_MpmcMold256* stm = (emStream_MpmcMold256*)stream;
+	emType_Bits32 max = stm->Max, pos, i, part;
+	if(emStream_MpmcClaimFn(&stm->Rear, stm->Seq, max, len, 0, &pos)) return 0xFF;
+	part = max + 1 - (pos & max);
+	if(part > len) part = len;
+	memcpy(stm->Data + (pos & max), src, part);
+	memcpy(stm->Data, src + part, len - part);
+	for(i=0; i<len; i++)
+		emType_StoreRelease(stm->Seq[(pos + i) & max], pos + i + 1);
+	return 0;
+}
+
+byte emStream_MpmcReadBytesFn(void* stream, byte* dst, uint len)
+{
+	emStream_MpmcMold256* stm = (emStream_MpmcMold256*)stream;
+	emType_Bits32 max = stm->Max, pos, i, part;
+	if(emStream_MpmcClaimFn(&stm->Front, stm->Seq, max, len, 1, &pos)) return 0xFF;
+	part = max + 1 - (pos & max);
+	if(part > len) part = len;
+	memcpy(dst, stm->Data + (pos & max), part);
+	memcpy(dst + part, stm->Data, len - part);
+	for(i=0; i<len; i++)
+		emType_StoreRelease(stm->Seq[(pos + i) & max], pos + i + max + 1);
+	return 0;
+}
+
+#define	emStream_MpmcWriteBytes(stream, src, len)	\
+	emStream_MpmcWriteBytesFn(stream, (byte*)(src), (uint)(len))
+
+#define	emStream_MpmcReadBytes(stream, dst, len)	\
+	emStream_MpmcReadBytesFn(stream, (byte*)(dst), (uint)(len))
+
+#if emStream_Shorthand >= 1
+#define	stream_MpmcWriteBytes	emStream_MpmcWriteBytes
+#define	stream_MpmcReadBytes	emStream_MpmcReadBytes
+#endif
+
+#if	emStream_Shorthand >= 2
+#define	stmMpmcWriteBytes		emStream_MpmcWriteBytes
+#define	stmMpmcReadBytes		emStream_MpmcReadBytes
+#endif
+
+
+
+// Function:
+// MpmcRead<Type>(*stream)
+// MpmcRead<Type>(*stream, *dst)
+// MpmcWrite<Type>(*stream, value)
+// 
+// Reads a type data from, or writes a type data to an MPMC stream, as a single
+// batch. These never block. When reading without destination address (dst),
+// 0 is returned if sufficient bytes are not available.
+// 
+// Parameters:
+// stream:	the MPMC stream
+// dst:		destination address where type value is stored
+// value:	the type value to be written
+// 
+// Returns: (if dst not used)
+// <Type>_value:	the value of type data read
+// 
+// Returns: (if dst is used / on write)
+// status:	0 for success, 0xFF for insufficient free space / bytes
+//
+#define	emStream_MpmcReadTypeVal(stream, type, dst)	\
+	emStream_MpmcReadBytesFn(stream, (byte*)(dst), sizeof(type))
+
+#define	emStream_MpmcReadTypeRet(stream, type)	\
+	({	\
+		type emStream_Value = 0;	\
+		emStream_MpmcReadBytesFn(stream, (byte*)&emStream_Value, sizeof(type));	\
+		emStream_Value;	\
+	})
+
+#define	emStream_MpmcWriteType(stream, type, value)	\
+	({	\
+		type emStream_Value = (type)(value);	\
+		emStream_MpmcWriteBytesFn(stream, (byte*)&emStream_Value, sizeof(type));	\
+	})
+
+#define	emStream_MpmcReadByteVal(stream, dst)	\
+	emStream_MpmcReadTypeVal(stream, byte, dst)
+
+#define	emStream_MpmcReadByteRet(stream)	\
+	emStream_MpmcReadTypeRet(stream, byte)
+
+#define	emStream_MpmcReadByte(...)	\
+	Macro(Macro2(__VA_ARGS__, emStream_MpmcReadByteVal, emStream_MpmcReadByteRet)(__VA_ARGS__))
+
+#define	emStream_MpmcWriteByte(stream, value)	\
+	emStream_MpmcWriteType(stream, byte, value)
+
+#define	emStream_MpmcReadSbyteVal(stream, dst)	\
+	emStream_MpmcReadTypeVal(stream, sbyte, dst)
+
+#define	emStream_MpmcReadSbyteRet(stream)	\
+	emStream_MpmcReadTypeRet(stream, sbyte)
+
+#define	emStream_MpmcReadSbyte(...)	\
+	Macro(Macro2(__VA_ARGS__, emStream_MpmcReadSbyteVal, emStream_MpmcReadSbyteRet)(__VA_ARGS__))
+
+#define	emStream_MpmcWriteSbyte(stream, value)	\
+	emStream_MpmcWriteType(stream, sbyte, value)
+
+#define	emStream_MpmcReadShortVal(stream, dst)	\
+	emStream_MpmcReadTypeVal(stream, short, dst)
+
+#define	emStream_MpmcReadShortRet(stream)	\
+	emStream_MpmcReadTypeRet(stream, short)
+
+#define	emStream_MpmcReadShort(...)	\
+	Macro(Macro2(__VA_ARGS__, emStream_MpmcReadShortVal, emStream_MpmcReadShortRet)(__VA_ARGS__))
+
+#define	emStream_MpmcWriteShort(stream, value)	\
+	emStream_MpmcWriteType(stream, short, value)
+
+#define	emStream_MpmcReadUshortVal(stream, dst)	\
+	emStream_MpmcReadTypeVal(stream, ushort, dst)
+
+#define	emStream_MpmcReadUshortRet(stream)	\
+	emStream_MpmcReadTypeRet(stream, ushort)
+
+#define	emStream_MpmcReadUshort(...)	\
+	Macro(Macro2(__VA_ARGS__, emStream_MpmcReadUshortVal, emStream_MpmcReadUshortRet)(__VA_ARGS__))
+
+#define	emStream_MpmcWriteUshort(stream, value)	\
+	emStream_MpmcWriteType(stream, ushort, value)
+
+#define	emStream_MpmcReadIntVal(stream, dst)	\
+	emStream_MpmcReadTypeVal(stream, int, dst)
+
+#define	emStream_MpmcReadIntRet(stream)	\
+	emStream_MpmcReadTypeRet(stream, int)
+
+#define	emStream_MpmcReadInt(...)	\
+	Macro(Macro2(__VA_ARGS__, emStream_MpmcReadIntVal, emStream_MpmcReadIntRet)(__VA_ARGS__))
+
+#define	emStream_MpmcWriteInt(stream, value)	\
+	emStream_MpmcWriteType(stream, int, value)
+
+#define	emStream_MpmcReadUintVal(stream, dst)	\
+	emStream_MpmcReadTypeVal(stream, uint, dst)
+
+#define	emStream_MpmcReadUintRet(stream)	\
+	emStream_MpmcReadTypeRet(stream, uint)
+
+#define	emStream_MpmcReadUint(...)	\
+	Macro(Macro2(__VA_ARGS__, emStream_MpmcReadUintVal, emStream_MpmcReadUintRet)(__VA_ARGS__))
+
+#define	emStream_MpmcWriteUint(stream, value)	\
+	emStream_MpmcWriteType(stream, uint, value)
+
+#define	emStream_MpmcReadLongVal(stream, dst)	\
+	emStream_MpmcReadTypeVal(stream, long, dst)
+
+#define	emStream_MpmcReadLongRet(stream)	\
+	emStream_MpmcReadTypeRet(stream, long)
+
+#define	emStream_MpmcReadLong(...)	\
+	Macro(Macro2(__VA_ARGS__, emStream_MpmcReadLongVal, emStream_MpmcReadLongRet)(__VA_ARGS__))
+
+#define	emStream_MpmcWriteLong(stream, value)	\
+	emStream_MpmcWriteType(stream, long, value)
+
+#define	emStream_MpmcReadUlongVal(stream, dst)	\
+	emStream_MpmcReadTypeVal(stream, ulong, dst)
+
+#define	emStream_MpmcReadUlongRet(stream)	\
+	emStream_MpmcReadTypeRet(stream, ulong)
+
+#define	emStream_MpmcReadUlong(...)	\
+	Macro(Macro2(__VA_ARGS__, emStream_MpmcReadUlongVal, emStream_MpmcReadUlongRet)(__VA_ARGS__))
+
+#define	emStream_MpmcWriteUlong(stream, value)	\
+	emStream_MpmcWriteType(stream, ulong, value)
+
+#define	emStream_MpmcReadCharVal(stream, dst)	\
+	emStream_MpmcReadTypeVal(stream, char, dst)
+
+#define	emStream_MpmcReadCharRet(stream)	\
+	emStream_MpmcReadTypeRet(stream, char)
+
+#define	emStream_MpmcReadChar(...)	\
+	Macro(Macro2(__VA_ARGS__, emStream_MpmcReadCharVal, emStream_MpmcReadCharRet)(__VA_ARGS__))
+
+#define	emStream_MpmcWriteChar(stream, value)	\
+	emStream_MpmcWriteType(stream, char, value)
+
+#define	emStream_MpmcReadInt8Val(stream, dst)	\
+	emStream_MpmcReadTypeVal(stream, int8, dst)
+
+#define	emStream_MpmcReadInt8Ret(stream)	\
+	emStream_MpmcReadTypeRet(stream, int8)
+
+#define	emStream_MpmcReadInt8(...)	\
+	Macro(Macro2(__VA_ARGS__, emStream_MpmcReadInt8Val, emStream_MpmcReadInt8Ret)(__VA_ARGS__))
+
+#define	emStream_MpmcWriteInt8(stream, value)	\
+	emStream_MpmcWriteType(stream, int8, value)
+
+#define	emStream_MpmcReadUint8Val(stream, dst)	\
+	emStream_MpmcReadTypeVal(stream, uint8, dst)
+
+#define	emStream_MpmcReadUint8Ret(stream)	\
+	emStream_MpmcReadTypeRet(stream, uint8)
+
+#define	emStream_MpmcReadUint8(...)	\
+	Macro(Macro2(__VA_ARGS__, emStream_MpmcReadUint8Val, emStream_MpmcReadUint8Ret)(__VA_ARGS__))
+
+#define	emStream_MpmcWriteUint8(stream, value)	\
+	emStream_MpmcWriteType(stream, uint8, value)
+
+#define	emStream_MpmcReadInt16Val(stream, dst)	\
+	emStream_MpmcReadTypeVal(stream, int16, dst)
+
+#define	emStream_MpmcReadInt16Ret(stream)	\
+	emStream_MpmcReadTypeRet(stream, int16)
+
+#define	emStream_MpmcReadInt16(...)	\
+	Macro(Macro2(__VA_ARGS__, emStream_MpmcReadInt16Val, emStream_MpmcReadInt16Ret)(__VA_ARGS__))
+
+#define	emStream_MpmcWriteInt16(stream, value)	\
+	emStream_MpmcWriteType(stream, int16, value)
+
+#define	emStream_MpmcReadUint16Val(stream, dst)	\
+	emStream_MpmcReadTypeVal(stream, uint16, dst)
+
+#define	emStream_MpmcReadUint16Ret(stream)	\
+	emStream_MpmcReadTypeRet(stream, uint16)
+
+#define	emStream_MpmcReadUint16(...)	\
+	Macro(Macro2(__VA_ARGS__, emStream_MpmcReadUint16Val, emStream_MpmcReadUint16Ret)(__VA_ARGS__))
+
+#define	emStream_MpmcWriteUint16(stream, value)	\
+	emStream_MpmcWriteType(stream, uint16, value)
+
+#define	emStream_MpmcReadInt32Val(stream, dst)	\
+	emStream_MpmcReadTypeVal(stream, int32, dst)
+
+#define	emStream_MpmcReadInt32Ret(stream)	\
+	emStream_MpmcReadTypeRet(stream, int32)
+
+#define	emStream_MpmcReadInt32(...)	\
+	Macro(Macro2(__VA_ARGS__, emStream_MpmcReadInt32Val, emStream_MpmcReadInt32Ret)(__VA_ARGS__))
+
+#define	emStream_MpmcWriteInt32(stream, value)	\
+	emStream_MpmcWriteType(stream, int32, value)
+
+#define	emStream_MpmcReadUint32Val(stream, dst)	\
+	emStream_MpmcReadTypeVal(stream, uint32, dst)
+
+#define	emStream_MpmcReadUint32Ret(stream)	\
+	emStream_MpmcReadTypeRet(stream, uint32)
+
+#define	emStream_MpmcReadUint32(...)	\
+	Macro(Macro2(__VA_ARGS__, emStream_MpmcReadUint32Val, emStream_MpmcReadUint32Ret)(__VA_ARGS__))
+
+#define	emStream_MpmcWriteUint32(stream, value)	\
+	emStream_MpmcWriteType(stream, uint32, value)
+
+#define	emStream_MpmcReadInt64Val(stream, dst)	\
+	emStream_MpmcReadTypeVal(stream, int64, dst)
+
+#define	emStream_MpmcReadInt64Ret(stream)	\
+	emStream_MpmcReadTypeRet(stream, int64)
+
+#define	emStream_MpmcReadInt64(...)	\
+	Macro(Macro2(__VA_ARGS__, emStream_MpmcReadInt64Val, emStream_MpmcReadInt64Ret)(__VA_ARGS__))
+
+#define	emStream_MpmcWriteInt64(stream, value)	\
+	emStream_MpmcWriteType(stream, int64, value)
+
+#define	emStream_MpmcReadUint64Val(stream, dst)	\
+	emStream_MpmcReadTypeVal(stream, uint64, dst)
+
+#define	emStream_MpmcReadUint64Ret(stream)	\
+	emStream_MpmcReadTypeRet(stream, uint64)
+
+#define	emStream_MpmcReadUint64(...)	\
+	Macro(Macro2(__VA_ARGS__, emStream_MpmcReadUint64Val, emStream_MpmcReadUint64Ret)(__VA_ARGS__))
+
+#define	emStream_MpmcWriteUint64(stream, value)	\
+	emStream_MpmcWriteType(stream, uint64, value)
+
+#define	emStream_MpmcReadFloatVal(stream, dst)	\
+	emStream_MpmcReadTypeVal(stream, float, dst)
+
+#define	emStream_MpmcReadFloatRet(stream)	\
+	emStream_MpmcReadTypeRet(stream, float)
+
+#define	emStream_MpmcReadFloat(...)	\
+	Macro(Macro2(__VA_ARGS__, emStream_MpmcReadFloatVal, emStream_MpmcReadFloatRet)(__VA_ARGS__))
+
+#define	emStream_MpmcWriteFloat(stream, value)	\
+	emStream_MpmcWriteType(stream, float, value)
+
+#define	emStream_MpmcReadDoubleVal(stream, dst)	\
+	emStream_MpmcReadTypeVal(stream, double, dst)
+
+#define	emStream_MpmcReadDoubleRet(stream)	\
+	emStream_MpmcReadTypeRet(stream, double)
+
+#define	emStream_MpmcReadDouble(...)	\
+	Macro(Macro2(__VA_ARGS__, emStream_MpmcReadDoubleVal, emStream_MpmcReadDoubleRet)(__VA_ARGS__))
+
+#define	emStream_MpmcWriteDouble(stream, value)	\
+	emStream_MpmcWriteType(stream, double, value)
+
+#if emStream_Shorthand >= 1
+#define	stream_MpmcReadByte		emStream_MpmcReadByte
+#define	stream_MpmcReadSbyte	emStream_MpmcReadSbyte
+#define	stream_MpmcReadShort	emStream_MpmcReadShort
+#define	stream_MpmcReadUshort	emStream_MpmcReadUshort
+#define	stream_MpmcReadInt		emStream_MpmcReadInt
+#define	stream_MpmcReadUint		emStream_MpmcReadUint
+#define	stream_MpmcReadLong		emStream_MpmcReadLong
+#define	stream_MpmcReadUlong	emStream_MpmcReadUlong
+#define	stream_MpmcReadChar		emStream_MpmcReadChar
+#define	stream_MpmcReadInt8		emStream_MpmcReadInt8
+#define	stream_MpmcReadUint8	emStream_MpmcReadUint8
+#define	stream_MpmcReadInt16	emStream_MpmcReadInt16
+#define	stream_MpmcReadUint16	emStream_MpmcReadUint16
+#define	stream_MpmcReadInt32	emStream_MpmcReadInt32
+#define	stream_MpmcReadUint32	emStream_MpmcReadUint32
+#define	stream_MpmcReadInt64	emStream_MpmcReadInt64
+#define	stream_MpmcReadUint64	emStream_MpmcReadUint64
+#define	stream_MpmcReadFloat	emStream_MpmcReadFloat
+#define	stream_MpmcReadDouble	emStream_MpmcReadDouble
+#define	stream_MpmcWriteByte	emStream_MpmcWriteByte
+#define	stream_MpmcWriteSbyte	emStream_MpmcWriteSbyte
+#define	stream_MpmcWriteShort	emStream_MpmcWriteShort
+#define	stream_MpmcWriteUshort	emStream_MpmcWriteUshort
+#define	stream_MpmcWriteInt		emStream_MpmcWriteInt
+#define	stream_MpmcWriteUint	emStream_MpmcWriteUint
+#define	stream_MpmcWriteLong	emStream_MpmcWriteLong
+#define	stream_MpmcWriteUlong	emStream_MpmcWriteUlong
+#define	stream_MpmcWriteChar	emStream_MpmcWriteChar
+#define	stream_MpmcWriteInt8	emStream_MpmcWriteInt8
+#define	stream_MpmcWriteUint8	emStream_MpmcWriteUint8
+#define	stream_MpmcWriteInt16	emStream_MpmcWriteInt16
+#define	stream_MpmcWriteUint16	emStream_MpmcWriteUint16
+#define	stream_MpmcWriteInt32	emStream_MpmcWriteInt32
+#define	stream_MpmcWriteUint32	emStream_MpmcWriteUint32
+#define	stream_MpmcWriteInt64	emStream_MpmcWriteInt64
+#define	stream_MpmcWriteUint64	emStream_MpmcWriteUint64
+#define	stream_MpmcWriteFloat	emStream_MpmcWriteFloat
+#define	stream_MpmcWriteDouble	emStream_MpmcWriteDouble
+#endif
+
+#if	emStream_Shorthand >= 2
+#define	stmMpmcReadByte		emStream_MpmcReadByte
+#define	stmMpmcReadSbyte		emStream_MpmcReadSbyte
+#define	stmMpmcReadShort		emStream_MpmcReadShort
+#define	stmMpmcReadUshort		emStream_MpmcReadUshort
+#define	stmMpmcReadInt		emStream_MpmcReadInt
+#define	stmMpmcReadUint		emStream_MpmcReadUint
+#define	stmMpmcReadLong		emStream_MpmcReadLong
+#define	stmMpmcReadUlong		emStream_MpmcReadUlong
+#define	stmMpmcReadChar		emStream_MpmcReadChar
+#define	stmMpmcReadInt8		emStream_MpmcReadInt8
+#define	stmMpmcReadUint8		emStream_MpmcReadUint8
+#define	stmMpmcReadInt16		emStream_MpmcReadInt16
+#define	stmMpmcReadUint16		emStream_MpmcReadUint16
+#define	stmMpmcReadInt32		emStream_MpmcReadInt32
+#define	stmMpmcReadUint32		emStream_MpmcReadUint32
+#define	stmMpmcReadInt64		emStream_MpmcReadInt64
+#define	stmMpmcReadUint64		emStream_MpmcReadUint64
+#define	stmMpmcReadFloat		emStream_MpmcReadFloat
+#define	stmMpmcReadDouble		emStream_MpmcReadDouble
+#define	stmMpmcWriteByte		emStream_MpmcWriteByte
+#define	stmMpmcWriteSbyte		emStream_MpmcWriteSbyte
+#define	stmMpmcWriteShort		emStream_MpmcWriteShort
+#define	stmMpmcWriteUshort		emStream_MpmcWriteUshort
+#define	stmMpmcWriteInt		emStream_MpmcWriteInt
+#define	stmMpmcWriteUint		emStream_MpmcWriteUint
+#define	stmMpmcWriteLong		emStream_MpmcWriteLong
+#define	stmMpmcWriteUlong		emStream_MpmcWriteUlong
+#define	stmMpmcWriteChar		emStream_MpmcWriteChar
+#define	stmMpmcWriteInt8		emStream_MpmcWriteInt8
+#define	stmMpmcWriteUint8		emStream_MpmcWriteUint8
+#define	stmMpmcWriteInt16		emStream_MpmcWriteInt16
+#define	stmMpmcWriteUint16		emStream_MpmcWriteUint16
+#define	stmMpmcWriteInt32		emStream_MpmcWriteInt32
+#define	stmMpmcWriteUint32		emStream_MpmcWriteUint32
+#define	stmMpmcWriteInt64		emStream_MpmcWriteInt64
+#define	stmMpmcWriteUint64		emStream_MpmcWriteUint64
+#define	stmMpmcWriteFloat		emStream_MpmcWriteFloat
+#define	stmMpmcWriteDouble		emStream_MpmcWriteDouble
+#endif
+#endif
+
+
+
 #endif
@@ -54,22 +54,87 @@
 
 
 
+// Select task removal order
+// 
+// When set to 1, Remove() moves the last task into the
+// place of the removed task, which takes constant time
+// but does not preserve the round-robin order of tasks.
+// The default is 0 (order is preserved). It can be selected
+// in the main header file of embd library
+#ifndef	emTask_UnorderedRemove
+#define	emTask_UnorderedRemove	0
+#endif
+
+
+
+// Select scheduling options
+// 
+// Priorities is the number of priority levels of tasks
+// (1 to 8). A ready task of a higher level is always run
+// before those of lower levels. When EDF is 1, ready tasks
+// of the same level run in order of their Deadline
+// (earliest first), instead of FIFO order. When Latency is
+// 1, the worst-case dispatch latency of each level is
+// recorded (see GetLatency()). The defaults are 8, 0 and 0.
+// They can be selected in the main header file of embd
+// library
+#ifndef	emTask_Priorities
+#define	emTask_Priorities		8
+#endif
+
+#ifndef	emTask_EDF
+#define	emTask_EDF				0
+#endif
+
+#ifndef	emTask_Latency
+#define	emTask_Latency			0
+#endif
+
+
+
 // Individual Task Mold format
 // 
 // Each task needs to have an object of an individual task mold. It is used to store
-// continuation line, task status, and state buffer. Depending on the size a state
-// buffer required, an appropriate task mold needs to be chosen. State buffer is used
-// to store state variables (non-global) which need to restored after the task has
-// regained the CPU. The range is from 8 to 256 bytes (by default, provided in powers
-// of 2). For any different size mold, MoldMake() can be used make a mold of desired
-// size.
-// 
+// continuation line, task status, priority level, a cursor (used by blocking
+// operations, like stream transfers, to remember their progress while waiting), the
+// task function, links to the queue (ready queue, or the queue of an event it waits
+// on) it is in, the worker it is kept on (Affinity, see RunWorkers()), the worker
+// whose queue it is in, or if it waits (Worker), the time it sleeps until, or is due
+// by with EDF (Deadline), the time it was made ready (Stamp, only with Latency), and
+// state buffer. Depending on the size a state buffer required, an appropriate task
+// mold needs to be chosen. State buffer is used to store state variables
+// (non-global) which need to restored after the task has regained the CPU. The
+// range is from 8 to 256 bytes (by default, provided in powers of 2). For any
+// different size mold, MoldMake() can be used make a mold of desired size.
+// 
+struct _emTask_Mold256;
+
+struct _emTask_Event;
+
+typedef byte (*emTask_FnPtr)(struct _emTask_Mold256*);
+
+#if emTask_Latency
+#define	emTask_MoldStamp		emType_Bits32	Stamp;
+#else
+#define	emTask_MoldStamp
+#endif
+
 #if	emTask_Shorthand == 0
 #define	emTask_MoldMake(size)	\
 typedef	struct _emTask_Mold##size	\
 {	\
 	int		Line;	\
 	byte	Status;	\
+	byte	Priority;	\
+	byte	Affinity;	\
+	byte	Worker;	\
+	uint	Cursor;	\
+	emType_Bits32	Deadline;	\
+	emTask_MoldStamp	\
+	emTask_FnPtr	Fn;	\
+	struct _emTask_Event*	Queue;	\
+	struct _emTask_Mold256*	Prev;	\
+	struct _emTask_Mold256*	Next;	\
 	byte	State[size];	\
 }emTask_Mold##size
 #elif emTask_Shorthand == 1
@@ -78,6 +143,16 @@ typedef	struct _emTask_Mold##size	\
 {	\
 	int		Line;	\
 	byte	Status;	\
+	byte	Priority;	\
+	byte	Affinity;	\
+	byte	Worker;	\
+	uint	Cursor;	\
+	emType_Bits32	Deadline;	\
+	emTask_MoldStamp	\
+	emTask_FnPtr	Fn;	\
+	struct _emTask_Event*	Queue;	\
+	struct _emTask_Mold256*	Prev;	\
+	struct _emTask_Mold256*	Next;	\
 	byte	State[size];	\
 }emTask_Mold##size, task_Mold##size
 #elif emTask_Shorthand == 2
@@ -86,6 +161,16 @@ typedef	struct _emTask_Mold##size	\
 {	\
 	int		Line;	\
 	byte	Status;	\
+	byte	Priority;	\
+	byte	Affinity;	\
+	byte	Worker;	\
+	uint	Cursor;	\
+	emType_Bits32	Deadline;	\
+	emTask_MoldStamp	\
+	emTask_FnPtr	Fn;	\
+	struct _emTask_Event*	Queue;	\
+	struct _emTask_Mold256*	Prev;	\
+	struct _emTask_Mold256*	Next;	\
 	byte	State[size];	\
 }emTask_Mold##size, task_Mold##size, tskMold##size
 #endif
@@ -106,20 +191,103 @@ emTask_MoldMake(128);
 
 emTask_MoldMake(256);
 
-typedef byte (*emTask_FnPtr)(emTask_Mold256*);
-
-typedef int emTask_Semaphore;
-
 #if emTask_Shorthand >= 1
 #define	task_MoldMake			emTask_MoldMake
 #define	task_FnPtr				emTask_FnPtr
-#define	task_Semaphore			emTask_Semaphore
 #endif
 
 #if	emTask_Shorthand >= 2
 #define	tskMoldMake				emTask_MoldMake
 #define	tskFnPtr				emTask_FnPtr
+#endif
+
+
+
+// Event format
+// 
+// An event is a FIFO queue of tasks waiting for something to happen (such as data
+// arriving in a stream). A task waiting on an event with WaitEventWhile() is parked
+// in its queue, and is not executed by Run() until the event is signalled. Each
+// priority level of the ready queue of Run() has the same format. Link and Posted
+// are used by EventPost(). An event that has been posted must remain valid until
+// Run() has handled the post.
+// 
+typedef struct _emTask_Event
+{
+	emTask_Mold256*			Head;
+	emTask_Mold256*			Tail;
+	struct _emTask_Event*	Link;
+	volatile byte			Posted;
+}emTask_Event;
+
+#if emTask_Shorthand >= 1
+#define	task_Event				emTask_Event
+#endif
+
+#if	emTask_Shorthand >= 2
+#define	tskEvent				emTask_Event
+#endif
+
+
+
+// Ready set format
+// 
+// A ready set holds the ready tasks, with a queue for each priority level, and a
+// bitmap (Map) of the levels that have tasks, so that the highest level with a ready
+// task is found in constant time.
+// 
+typedef struct _emTask_ReadySet
+{
+	emTask_Event	Level[emTask_Priorities];
+	byte			Map;
+}emTask_ReadySet;
+
+#if emTask_Shorthand >= 1
+#define	task_ReadySet			emTask_ReadySet
+#endif
+
+#if	emTask_Shorthand >= 2
+#define	tskReadySet				emTask_ReadySet
+#endif
+
+
+
+// Semaphore, Mutex and Condition format
+// 
+// A semaphore holds a count of units, a mutex holds the task that owns it (Owner),
+// and a condition holds the mutex that was given with its last wait. Each has a FIFO
+// queue of the tasks waiting on it (Wait), in the format of an event. A waiting task
+// is parked in the queue, and is not executed until it is handed the semaphore unit
+// or mutex it waits for (see SemWait(), MutexLock() and CondWait()).
+// 
+typedef struct _emTask_Semaphore
+{
+	emTask_Event	Wait;
+	int				Count;
+}emTask_Semaphore;
+
+typedef struct _emTask_Mutex
+{
+	emTask_Event		Wait;
+	emTask_Mold256*		Owner;
+}emTask_Mutex;
+
+typedef struct _emTask_Cond
+{
+	emTask_Event		Wait;
+	emTask_Mutex*		Mutex;
+}emTask_Cond;
+
+#if emTask_Shorthand >= 1
+#define	task_Semaphore			emTask_Semaphore
+#define	task_Mutex				emTask_Mutex
+#define	task_Cond				emTask_Cond
+#endif
+
+#if	emTask_Shorthand >= 2
 #define	tskSemaphore			emTask_Semaphore
+#define	tskMutex				emTask_Mutex
+#define	tskCond					emTask_Cond
 #endif
 
 
@@ -166,26 +334,166 @@ emList_TaskListMoldMake(256);
 #endif
 
 emList_TaskListMold*	emTask;
-byte					emTask_RunIndex;	
+emTask_ReadySet			emTask_Ready;
+emTask_Event* volatile	emTask_Posted;
 byte					emTask_ExitStatus;
 
 #if emTask_Shorthand >= 1
-#define	task_RunIndex			emTask_RunIndex
+#define	task_Ready				emTask_Ready
 #define	task_ExitStatus			emTask_ExitStatus
 #endif
 
 #if	emTask_Shorthand >= 2
-#define	tskRunIndex				emTask_RunIndex
+#define	tskReady				emTask_Ready
 #define	tskExitStatus			emTask_ExitStatus
 #endif
 
 
 
+// Idle wait
+// 
+// When no task is ready to run, Run() waits for an event to be posted (with
+// EventPost()) instead of polling the tasks. On PC, the thread sleeps on a
+// condition variable. Elsewhere, IdleHook() is called, which does nothing by
+// default; it can be defined in the main header file of embd library (for
+// example, to put the processor to sleep until the next interrupt). Posts are
+// made safe with a mutex on PC, and by disabling interrupts on AVR.
+// 
+#if embd_Platform == embd_PlatformPC && ((defined(__cplusplus) && __cplusplus >= 201103L) || defined(_MSC_VER))
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#define	emTask_Doorbell			1
+std::mutex				emTask_BellLock;
+std::condition_variable	emTask_Bell;
+std::mutex				emTask_PostMutex;
+#define	emTask_PostLock()		emTask_PostMutex.lock()
+#define	emTask_PostUnlock()		emTask_PostMutex.unlock()
+#elif embd_Platform == embd_PlatformAVR
+#define	emTask_PostLock()		byte emTask_Sreg = SREG; cli()
+#define	emTask_PostUnlock()		SREG = emTask_Sreg
+#else
+#define	emTask_PostLock()
+#define	emTask_PostUnlock()
+#endif
+
+#ifndef	emTask_IdleHook
+#define	emTask_IdleHook()
+#endif
+
+
+
+// Clock
+// 
+// Now() gives the time in milliseconds, used for sleeping tasks (see Timer wheel),
+// and Ticks() gives the time in microseconds, used to measure dispatch latency.
+// Both wrap around, and can be defined in the main header file of embd library.
+// 
+#if defined(emTask_Doorbell)
+#include <chrono>
+#endif
+
+#ifndef	emTask_Now
+#if defined(emTask_Doorbell)
+#define	emTask_Now()	\
+	((emType_Bits32)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count())
+#elif embd_Platform == embd_PlatformAVR
+#define	emTask_Now()			((emType_Bits32)millis())
+#else
+#include <time.h>
+#define	emTask_Now()			((emType_Bits32)(clock() / (CLOCKS_PER_SEC / 1000)))
+#endif
+#endif
+
+#ifndef	emTask_Ticks
+#if defined(emTask_Doorbell)
+#define	emTask_Ticks()	\
+	((emType_Bits32)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count())
+#elif embd_Platform == embd_PlatformAVR
+#define	emTask_Ticks()			((emType_Bits32)micros())
+#else
+#define	emTask_Ticks()			(emTask_Now() * 1000)
+#endif
+#endif
+
+#if emTask_Shorthand >= 1
+#define	task_Now				emTask_Now
+#define	task_Ticks				emTask_Ticks
+#endif
+
+#if	emTask_Shorthand >= 2
+#define	tskNow					emTask_Now
+#define	tskTicks				emTask_Ticks
+#endif
+
+
+
+// Workers
+// 
+// On PC, tasks can also be executed by a number of worker threads with
+// RunWorkers(). Each worker has its own ready set (a deque for each priority
+// level), protected by its own lock. A worker runs tasks from the front of its own
+// highest ready level, and puts them back at its end; when it has no ready task it
+// steals one from the end of the highest ready level of another worker. So
+// priority levels (and EDF order) are followed by each worker for its own tasks.
+// A task whose Affinity is set to a worker number is always kept on that worker
+// (and never stolen), which is required for tasks that share data without locking
+// (such as a stream). Adding and removing tasks, and waiting on events are
+// serialized with a scheduler lock while workers are running. MaxWorkers is the
+// maximum number of workers, and can be selected in the main header file of embd
+// library.
+// 
+#define	emTask_AffinityAny		0xFF
+#define	emTask_WorkerWaiting	0xFE
+
+#if defined(emTask_Doorbell)
+#ifndef	emTask_MaxWorkers
+#define	emTask_MaxWorkers		64
+#endif
+
+typedef struct alignas(emType_CacheLine) _emTask_WorkerMold
+{
+	emTask_ReadySet		Ready;
+	std::mutex			Lock;
+	std::atomic<uint>	Count;
+}emTask_WorkerMold;
+
+emTask_WorkerMold			emTask_Worker[emTask_MaxWorkers];
+byte						emTask_Workers;
+emType_ThreadLocal byte		emTask_Self;
+std::mutex					emTask_SchedMutex;
+std::atomic<uint>			emTask_Stealable;
+std::atomic<byte>			emTask_Sleepers;
+std::atomic<byte>			emTask_Done;
+#define	emTask_SchedLock()		do{ if(emTask_Workers) emTask_SchedMutex.lock(); }while(0)
+#define	emTask_SchedUnlock()	do{ if(emTask_Workers) emTask_SchedMutex.unlock(); }while(0)
+#else
+#define	emTask_Workers			0
+#define	emTask_SchedLock()
+#define	emTask_SchedUnlock()
+#endif
+
+#if emTask_Shorthand >= 1
+#define	task_AffinityAny		emTask_AffinityAny
+#define	task_MaxWorkers			emTask_MaxWorkers
+#define	task_Workers			emTask_Workers
+#endif
+
+#if	emTask_Shorthand >= 2
+#define	tskAffinityAny			emTask_AffinityAny
+#define	tskMaxWorkers			emTask_MaxWorkers
+#define	tskWorkers				emTask_Workers
+#endif
+
+
+
 // Exit Status constants
 #define	emTask_StatusRan			0
 #define	emTask_StatusSwitched		1
 #define	emTask_StatusSwitchedOut	2
 #define	emTask_StatusWaiting		3
+#define	emTask_StatusBlocked		4
 #define	emTask_ExitStatusOk			0
 #define	emTask_ExitStatusError		0xFF
 
@@ -194,6 +502,7 @@ byte					emTask_ExitStatus;
 #define	task_StatusSwitched		emTask_StatusSwitched
 #define	task_StatusSwitchedOut	emTask_StatusSwitchedOut
 #define	task_StatusWaiting		emTask_StatusWaiting
+#define	task_StatusBlocked		emTask_StatusBlocked
 #define	task_StatusExited		emTask_StatusExited
 #define	task_ExitStatusOk		emTask_ExitStatusOk
 #define	task_ExitStatusError	emTask_ExitStatusError
@@ -204,6 +513,7 @@ byte					emTask_ExitStatus;
 #define	tskStatusSwitched		emTask_StatusSwitched
 #define	tskStatusSwitchedOut	emTask_StatusSwitchedOut
 #define	tskStatusWaiting		emTask_StatusWaiting
+#define	tskStatusBlocked		emTask_StatusBlocked
 #define	tskStatusExited			emTask_StatusExited
 #define	tskExitStatusOk			emTask_ExitStatusOk
 #define	tskExitStatusError		emTask_ExitStatusError
@@ -228,42 +538,720 @@ byte					emTask_ExitStatus;
 void emTask_InitMain(void* task_list)
 {
 	emTask = (emList_TaskListMold*)task_list;
-	emTask_RunIndex = 0;
+	memset(&emTask_Ready, 0, sizeof(emTask_Ready));
+	emTask_Posted = NULL;
 }
 
 #if emTask_Shorthand >= 1
 #define	task_InitMain			emTask_InitMain
 #endif
 
-#if	emTask_Shorthand >= 2
-#define	tskInitMain				emTask_InitMain
+#if	emTask_Shorthand >= 2
+#define	tskInitMain				emTask_InitMain
+#endif
+
+
+
+// Function:
+// Init(*task)
+// 
+// Initializes a task object (task) before use. The task gets the lowest priority
+// level (0); a different level (up to Priorities - 1) can be set in its Priority
+// after Init(), or by the task itself while it runs.
+// 
+// Parameters:
+// task:	the task object to initialize
+// 
+// Returns:
+// nothing
+//
+#define	emTask_Init(task)	\
+	do{	\
+		(*(task)).Line = 0;	\
+		(*(task)).Status = 0;	\
+		(*(task)).Priority = 0;	\
+		(*(task)).Affinity = emTask_AffinityAny;	\
+		(*(task)).Worker = emTask_AffinityAny;	\
+		(*(task)).Cursor = 0;	\
+		(*(task)).Deadline = 0;	\
+		(*(task)).Fn = NULL;	\
+		(*(task)).Queue = NULL;	\
+	}while(0)
+
+#if emTask_Shorthand >= 1
+#define	task_Init				emTask_Init
+#endif
+
+#if	emTask_Shorthand >= 2
+#define	tskInit					emTask_Init
+#endif
+
+
+
+// Function:
+// QueuePush(*queue, *task)
+// QueueInsert(*queue, *prev, *task)
+// QueuePop(*queue)
+// QueueUnlink(*task)
+// 
+// Adds a task at the end of a queue (ready queue, or queue of an event), or after
+// another task in it (at the front, if prev is NULL), removes the task at the front
+// of a queue, or removes a task from whichever queue it is in. All take constant
+// time, as the links are kept in the task object. A task added to a queue other
+// than a ready queue is marked as waiting (Worker), so that Remove() can tell it
+// apart from a task in the ready queue of a worker.
+// 
+// Parameters:
+// queue:	the queue (event)
+// prev:	the task after which to add (NULL for front)
+// task:	the task object
+// 
+// Returns:
+// task:	the task removed from the front (QueuePop(), NULL if queue is empty)
+//
+void emTask_QueueCutFn(emTask_Mold256* task)
+{
+	emTask_Event* queue = task->Queue;
+	if(task->Prev) task->Prev->Next = task->Next;
+	else queue->Head = task->Next;
+	if(task->Next) task->Next->Prev = task->Prev;
+	else queue->Tail = task->Prev;
+	task->Queue = NULL;
+}
+
+void emTask_QueueLinkFn(emTask_Event* queue, emTask_Mold256* prev, emTask_Mold256* task)
+{
+	task->Queue = queue;
+	task->Prev = prev;
+	task->Next = prev? prev->Next : queue->Head;
+	if(task->Next) task->Next->Prev = task;
+	else queue->Tail = task;
+	if(prev) prev->Next = task;
+	else queue->Head = task;
+}
+
+void emTask_QueueUnlinkFn(emTask_Mold256* task)
+{
+	if(task->Queue == NULL) return;
+	emTask_QueueCutFn(task);
+	emType_StoreRelease(task->Worker, (byte)emTask_AffinityAny);
+}
+
+void emTask_QueuePushFn(emTask_Event* queue, emTask_Mold256* task)
+{
+	emType_StoreRelease(task->Worker, (byte)emTask_WorkerWaiting);
+	emTask_QueueLinkFn(queue, queue->Tail, task);
+}
+
+void emTask_QueueInsertFn(emTask_Event* queue, emTask_Mold256* prev, emTask_Mold256* task)
+{
+	emType_StoreRelease(task->Worker, (byte)emTask_WorkerWaiting);
+	emTask_QueueLinkFn(queue, prev, task);
+}
+
+emTask_Mold256* emTask_QueuePopFn(emTask_Event* queue)
+{
+	emTask_Mold256* task = queue->Head;
+	if(task) emTask_QueueUnlinkFn(task);
+	return task;
+}
+
+#define	emTask_QueuePush(queue, task)	\
+	emTask_QueuePushFn(queue, (emTask_Mold256*)(task))
+
+#define	emTask_QueueInsert(queue, prev, task)	\
+	emTask_QueueInsertFn(queue, (emTask_Mold256*)(prev), (emTask_Mold256*)(task))
+
+#define	emTask_QueuePop(queue)	\
+	emTask_QueuePopFn(queue)
+
+#define	emTask_QueueUnlink(task)	\
+	emTask_QueueUnlinkFn((emTask_Mold256*)(task))
+
+#if emTask_Shorthand >= 1
+#define	task_QueuePush			emTask_QueuePush
+#define	task_QueueInsert		emTask_QueueInsert
+#define	task_QueuePop			emTask_QueuePop
+#define	task_QueueUnlink		emTask_QueueUnlink
+#endif
+
+#if	emTask_Shorthand >= 2
+#define	tskQueuePush			emTask_QueuePush
+#define	tskQueueInsert			emTask_QueueInsert
+#define	tskQueuePop				emTask_QueuePop
+#define	tskQueueUnlink			emTask_QueueUnlink
+#endif
+
+
+
+// Function:
+// ReadyPut(*ready, *task)
+// ReadyTake(*ready)
+// ReadySteal(*ready)
+// 
+// ReadyPut() adds a task to a ready set, in the queue of its priority level (at
+// its end, or in order of Deadline with EDF). A task that is polling a condition
+// (its Status is emTask_StatusWaiting) is put in the lowest level instead, so that
+// it does not keep the lower levels from running. ReadyTake() removes the first task of
+// the highest level that has tasks, and ReadySteal() removes the last task of the
+// highest level that has one which is not kept on a worker (Affinity). The highest
+// level is found from the bitmap in constant time.
+// 
+// Parameters:
+// ready:	the ready set
+// task:	the task object
+// 
+// Returns:
+// task:	the task removed (ReadyTake(), ReadySteal(), NULL if none)
+//
+byte emTask_MapTopFn(byte map)
+{
+	static const byte top[16] = {0, 0, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3};
+	return (map >> 4)? 4 + top[map >> 4] : top[map];
+}
+
+void emTask_ReadyPutFn(emTask_ReadySet* ready, emTask_Mold256* task)
+{
+	byte level = (task->Priority < emTask_Priorities)? task->Priority : emTask_Priorities - 1;
+	emTask_Event* queue;
+	if(task->Status == emTask_StatusWaiting) level = 0;
+	queue = &ready->Level[level];
+#if emTask_EDF
+	emTask_Mold256* prev;
+	for(prev = queue->Tail; prev && (emType_Sbits32)(task->Deadline - prev->Deadline) < 0; prev = prev->Prev);
+	emTask_QueueLinkFn(queue, prev, task);
+#else
+	emTask_QueueLinkFn(queue, queue->Tail, task);
+#endif
+#if emTask_Latency
+	task->Stamp = emTask_Ticks();
+#endif
+	ready->Map |= (byte)(1 << level);
+}
+
+emTask_Mold256* emTask_ReadyTakeFn(emTask_ReadySet* ready)
+{
+	emTask_Mold256* task;
+	byte level;
+	while(ready->Map)
+	{
+		level = emTask_MapTopFn(ready->Map);
+		task = ready->Level[level].Head;
+		if(task) emTask_QueueCutFn(task);
+		if(ready->Level[level].Head == NULL) ready->Map &= (byte)~(1 << level);
+		if(task) return task;
+	}
+	return NULL;
+}
+
+emTask_Mold256* emTask_ReadyStealFn(emTask_ReadySet* ready)
+{
+	emTask_Mold256* task;
+	byte map = ready->Map, level;
+	while(map)
+	{
+		level = emTask_MapTopFn(map);
+		for(task = ready->Level[level].Tail; task && task->Affinity != emTask_AffinityAny; task = task->Prev);
+		if(task)
+		{
+			emTask_QueueCutFn(task);
+			if(ready->Level[level].Head == NULL) ready->Map &= (byte)~(1 << level);
+			return task;
+		}
+		map &= (byte)~(1 << level);
+	}
+	return NULL;
+}
+
+#define	emTask_ReadyPut(ready, task)	\
+	emTask_ReadyPutFn(ready, (emTask_Mold256*)(task))
+
+#define	emTask_ReadyTake(ready)	\
+	emTask_ReadyTakeFn(ready)
+
+#define	emTask_ReadySteal(ready)	\
+	emTask_ReadyStealFn(ready)
+
+#if emTask_Shorthand >= 1
+#define	task_ReadyPut			emTask_ReadyPut
+#define	task_ReadyTake			emTask_ReadyTake
+#define	task_ReadySteal			emTask_ReadySteal
+#endif
+
+#if	emTask_Shorthand >= 2
+#define	tskReadyPut				emTask_ReadyPut
+#define	tskReadyTake			emTask_ReadyTake
+#define	tskReadySteal			emTask_ReadySteal
+#endif
+
+
+
+// Function:
+// ReadyPush(*task)
+// 
+// Puts a task in the ready queue. While workers are running, the task is put in
+// the queue of the worker it is kept on (Affinity), or else in the queue of the
+// current worker, and sleeping workers are woken up.
+// 
+// Parameters:
+// task:	the task object
+// 
+// Returns:
+// nothing
+//
+#if defined(emTask_Doorbell)
+void emTask_RingFn()
+{
+	{ std::lock_guard<std::mutex> lock(emTask_BellLock); }
+	emTask_Bell.notify_all();
+}
+
+void emTask_WorkerPushFn(emTask_Mold256* task, byte worker)
+{
+	emTask_WorkerMold* wrk;
+	if(task->Affinity != emTask_AffinityAny) worker = task->Affinity % emTask_Workers;
+	wrk = &emTask_Worker[worker];
+	wrk->Lock.lock();
+	emType_StoreRelease(task->Worker, worker);
+	emTask_ReadyPutFn(&wrk->Ready, task);
+	wrk->Count++;
+	if(task->Affinity == emTask_AffinityAny) emTask_Stealable++;
+	wrk->Lock.unlock();
+	if(emTask_Sleepers) emTask_RingFn();
+}
+
+emTask_Mold256* emTask_WorkerPopFn(byte worker)
+{
+	emTask_WorkerMold* wrk = &emTask_Worker[worker];
+	emTask_Mold256* task;
+	if(wrk->Count == 0) return NULL;
+	wrk->Lock.lock();
+	task = emTask_ReadyTakeFn(&wrk->Ready);
+	if(task)
+	{
+		emType_StoreRelease(task->Worker, emTask_AffinityAny);
+		wrk->Count--;
+		if(task->Affinity == emTask_AffinityAny) emTask_Stealable--;
+	}
+	wrk->Lock.unlock();
+	return task;
+}
+
+emTask_Mold256* emTask_WorkerStealFn(byte worker)
+{
+	emTask_WorkerMold* wrk;
+	emTask_Mold256* task;
+	byte i;
+	for(i=1; i<emTask_Workers && emTask_Stealable; i++)
+	{
+		wrk = &emTask_Worker[(worker + i) % emTask_Workers];
+		if(wrk->Count == 0) continue;
+		wrk->Lock.lock();
+		task = emTask_ReadyStealFn(&wrk->Ready);
+		if(task)
+		{
+			emType_StoreRelease(task->Worker, emTask_AffinityAny);
+			wrk->Count--;
+			emTask_Stealable--;
+		}
+		wrk->Lock.unlock();
+		if(task) return task;
+	}
+	return NULL;
+}
+
+void emTask_WorkerDropFn(emTask_Mold256* task, byte worker)
+{
+	emTask_WorkerMold* wrk = &emTask_Worker[worker];
+	emTask_Event* queue;
+	wrk->Lock.lock();
+	// the worker may have taken the task in the meantime
+	if(emType_LoadAcquire(task->Worker) == worker)
+	{
+		queue = task->Queue;
+		emTask_QueueCutFn(task);
+		if(queue->Head == NULL) wrk->Ready.Map &= (byte)~(1 << (queue - wrk->Ready.Level));
+		emType_StoreRelease(task->Worker, (byte)emTask_AffinityAny);
+		wrk->Count--;
+		if(task->Affinity == emTask_AffinityAny) emTask_Stealable--;
+	}
+	wrk->Lock.unlock();
+}
+#endif
+
+void emTask_ReadyPushFn(emTask_Mold256* task)
+{
+#if defined(emTask_Doorbell)
+	if(emTask_Workers)
+	{
+		emTask_WorkerPushFn(task, emTask_Self);
+		return;
+	}
+#endif
+	emTask_ReadyPutFn(&emTask_Ready, task);
+}
+
+#define	emTask_ReadyPush(task)	\
+	emTask_ReadyPushFn((emTask_Mold256*)(task))
+
+#if emTask_Shorthand >= 1
+#define	task_ReadyPush			emTask_ReadyPush
+#endif
+
+#if	emTask_Shorthand >= 2
+#define	tskReadyPush			emTask_ReadyPush
+#endif
+
+
+
+// Function:
+// EventInit(*event)
+// EventSignal(*event)
+// EventBroadcast(*event)
+// EventPost(*event)
+// 
+// EventInit() initializes an event before use. EventSignal() moves the first task
+// waiting on an event to the ready queue, and EventBroadcast() moves all of them.
+// These must only be used from tasks (or from the thread calling Run(), or from a
+// worker when workers are running). From an interrupt (or another thread), use
+// EventPost() instead, which marks the event and wakes up Run() if it is idle; the
+// waiting tasks are then moved to the ready queue by Run() itself. Posting an event
+// more than once before it is handled has the same effect as posting it once.
+// 
+// Parameters:
+// event:	the event
+// 
+// Returns:
+// status:	0 if a task was woken up, 0xFF if none were waiting (EventSignal())
+//
+#define	emTask_EventInit(event)	\
+	do{	\
+		(*(event)).Head = NULL;	\
+		(*(event)).Tail = NULL;	\
+		(*(event)).Link = NULL;	\
+		(*(event)).Posted = 0;	\
+	}while(0)
+
+byte emTask_EventSignalFn(emTask_Event* event)
+{
+	emTask_Mold256* task;
+	emTask_SchedLock();
+	task = emTask_QueuePopFn(event);
+	emTask_SchedUnlock();
+	if(task == NULL) return 0xFF;
+	emTask_ReadyPushFn(task);
+	return 0;
+}
+
+void emTask_EventBroadcastFn(emTask_Event* event)
+{
+	while(emTask_EventSignalFn(event) == 0);
+}
+
+void emTask_EventPostFn(emTask_Event* event)
+{
+#if defined(emTask_Doorbell)
+	byte ring = 0;
+#endif
+	emTask_PostLock();
+	if(!event->Posted)
+	{
+		event->Posted = 1;
+		event->Link = emTask_Posted;
+		emType_StoreRelease(emTask_Posted, event);
+#if defined(emTask_Doorbell)
+		ring = (event->Link == NULL);
+#endif
+	}
+	emTask_PostUnlock();
+#if defined(emTask_Doorbell)
+	if(ring) emTask_RingFn();
+#endif
+}
+
+void emTask_EventTakeFn()
+{
+	emTask_Event* event;
+	emTask_PostLock();
+	for(event = emTask_Posted; event; event = event->Link)
+	{
+		event->Posted = 0;
+		emTask_EventBroadcastFn(event);
+	}
+	emType_StoreRelease(emTask_Posted, (emTask_Event*)NULL);
+	emTask_PostUnlock();
+}
+
+#define	emTask_EventSignal(event)	\
+	emTask_EventSignalFn(event)
+
+#define	emTask_EventBroadcast(event)	\
+	emTask_EventBroadcastFn(event)
+
+#define	emTask_EventPost(event)	\
+	emTask_EventPostFn(event)
+
+#if emTask_Shorthand >= 1
+#define	task_EventInit			emTask_EventInit
+#define	task_EventSignal		emTask_EventSignal
+#define	task_EventBroadcast		emTask_EventBroadcast
+#define	task_EventPost			emTask_EventPost
+#endif
+
+#if	emTask_Shorthand >= 2
+#define	tskEventInit			emTask_EventInit
+#define	tskEventSignal			emTask_EventSignal
+#define	tskEventBroadcast		emTask_EventBroadcast
+#define	tskEventPost			emTask_EventPost
+#endif
+
+
+
+// Timer wheel
+// 
+// Sleeping tasks are kept in a hierarchical timing wheel, so that they cost
+// nothing until they expire. Level 0 has a slot for each millisecond of the
+// current cycle of WheelSize milliseconds, level 1 has a slot for each cycle of
+// level 0, and so on. A task goes into the level of the highest digit (of
+// WheelBits bits) in which its deadline differs from the wheel time, and when the
+// wheel time reaches a slot, its tasks move down a level (or become ready, at
+// level 0). Tasks beyond the last level wait in an overflow queue, which is
+// checked each time the last level wraps around. Run() skips directly to the next
+// slot that has tasks, and sleeps until then. The wheel takes (WheelLevels + 1) <<
+// WheelBits events of RAM, so it is left out on AVR by default (WheelLevels is 0),
+// and a sleeping task then stays ready, and checks its deadline each time it is
+// run. WheelBits and WheelLevels can be selected in the main header file of embd
+// library.
+// 
+#ifndef	emTask_WheelBits
+#if embd_Platform == embd_PlatformPC
+#define	emTask_WheelBits		6
+#else
+#define	emTask_WheelBits		4
+#endif
+#endif
+
+#ifndef	emTask_WheelLevels
+#if embd_Platform == embd_PlatformPC
+#define	emTask_WheelLevels		4
+#else
+#define	emTask_WheelLevels		0
+#endif
+#endif
+
+#define	emTask_WheelSize		(1 << emTask_WheelBits)
+#define	emTask_WheelMask		(emTask_WheelSize - 1)
+#define	emTask_Forever			((emType_Bits32)0xFFFFFFFF)
+
+#if emTask_WheelLevels > 0
+emTask_Event		emTask_Wheel[emTask_WheelLevels + 1][emTask_WheelSize];
+uint				emTask_WheelCount[emTask_WheelLevels + 1];
+uint				emTask_WheelPending;
+emType_Bits32		emTask_WheelNow;
+emType_Bits32		emTask_WheelNext;
+#endif
+
+#if emTask_Shorthand >= 1
+#define	task_Forever			emTask_Forever
+#endif
+
+#if	emTask_Shorthand >= 2
+#define	tskForever				emTask_Forever
+#endif
+
+
+
+// Function:
+// TimerAdd(*task, deadline)
+// TimerPoll()
+// TimerWait()
+// 
+// TimerAdd() puts a task to sleep in the timer wheel until the specified time
+// (deadline, from Now()), unless it has already passed. TimerPoll() makes the
+// tasks whose deadline has passed ready, and TimerWait() gives the time left till
+// the next slot of the wheel that has tasks. These are used by Run(), and by
+// WaitUntilDeadline(). Without the wheel (WheelLevels is 0), TimerAdd() only sets
+// the Deadline of the task, and fails (so that the task polls its deadline), and
+// TimerWait() always gives emTask_Forever.
+// 
+// Parameters:
+// task:		the task object
+// deadline:	time (in milliseconds) till which the task sleeps
+// 
+// Returns:
+// status:		0 if the task sleeps, 0xFF if deadline has passed (TimerAdd())
+// wait:		milliseconds to the next slot that has tasks, or emTask_Forever (TimerWait())
+//
+#if emTask_WheelLevels > 0
+#define	emTask_WheelShift(level)	\
+	(emTask_WheelBits * (level))
+
+#define	emTask_WheelDigit(time, level)	\
+	(((time) >> emTask_WheelShift(level)) & emTask_WheelMask)
+
+emType_Bits32 emTask_WheelWrapFn(emType_Bits32 time, byte level)
+{
+	if(emTask_WheelShift(level + 1) >= 32) return time + 1;
+	return ((time >> emTask_WheelShift(level + 1)) + 1) << emTask_WheelShift(level + 1);
+}
+
+void emTask_WheelPutFn(emTask_Mold256* task)
+{
+	emType_Bits32 diff = task->Deadline ^ emTask_WheelNow;
+	byte level;
+	if((emType_Sbits32)(task->Deadline - emTask_WheelNow) <= 0)
+	{
+		emTask_ReadyPushFn(task);
+		return;
+	}
+	for(level=0; level<emTask_WheelLevels; level++)
+		if(emTask_WheelShift(level + 1) >= 32 || (diff >> emTask_WheelShift(level + 1)) == 0) break;
+	if(level < emTask_WheelLevels) emTask_QueuePushFn(&emTask_Wheel[level][emTask_WheelDigit(task->Deadline, level)], task);
+	else emTask_QueuePushFn(&emTask_Wheel[level][0], task);
+	emTask_WheelCount[level]++;
+	emType_StoreRelease(emTask_WheelPending, emTask_WheelPending + 1);
+}
+
+byte emTask_WheelUnlinkFn(emTask_Mold256* task)
+{
+	emTask_Event* queue = task->Queue;
+	uint slot = (uint)(queue - &emTask_Wheel[0][0]);
+	if(queue < &emTask_Wheel[0][0] || slot >= (emTask_WheelLevels + 1) * emTask_WheelSize) return 0xFF;
+	emTask_QueueUnlinkFn(task);
+	emTask_WheelCount[slot >> emTask_WheelBits]--;
+	emType_StoreRelease(emTask_WheelPending, emTask_WheelPending - 1);
+	return 0;
+}
+
+void emTask_WheelCascadeFn(byte level, uint slot)
+{
+	emTask_Event* queue = &emTask_Wheel[level][slot];
+	emTask_Mold256* last = queue->Tail;
+	emTask_Mold256* task;
+	// tasks put back in the overflow queue go after the last one
+	while(last && (task = emTask_QueuePopFn(queue)) != NULL)
+	{
+		emTask_WheelCount[level]--;
+		emType_StoreRelease(emTask_WheelPending, emTask_WheelPending - 1);
+		emTask_WheelPutFn(task);
+		if(task == last) break;
+	}
+}
+
+void emTask_WheelTickFn(emType_Bits32 time)
+{
+	sbyte level;
+	emTask_WheelNow = time;
+	if(emTask_WheelShift(emTask_WheelLevels) < 32 && (time & ((((emType_Bits32)1) << (emTask_WheelShift(emTask_WheelLevels) & 31)) - 1)) == 0)
+		emTask_WheelCascadeFn(emTask_WheelLevels, 0);
+	for(level=emTask_WheelLevels-1; level>0; level--)
+		if((time & ((((emType_Bits32)1) << emTask_WheelShift(level)) - 1)) == 0) emTask_WheelCascadeFn((byte)level, emTask_WheelDigit(time, level));
+	emTask_WheelCascadeFn(0, emTask_WheelDigit(time, 0));
+}
+
+emType_Bits32 emTask_WheelNextFn()
+{
+	byte level;
+	uint slot;
+	emType_Bits32 base;
+	for(level=0; level<emTask_WheelLevels; level++)
+	{
+		if(emTask_WheelCount[level] == 0) continue;
+		for(slot=emTask_WheelDigit(emTask_WheelNow, level)+1; slot<emTask_WheelSize; slot++)
+		{
+			if(emTask_Wheel[level][slot].Head == NULL) continue;
+			base = (emTask_WheelShift(level + 1) >= 32)? 0 : emTask_WheelNow & ~((((emType_Bits32)1) << emTask_WheelShift(level + 1)) - 1);
+			return base | (((emType_Bits32)slot) << emTask_WheelShift(level));
+		}
+		return emTask_WheelWrapFn(emTask_WheelNow, level);
+	}
+	return emTask_WheelWrapFn(emTask_WheelNow, emTask_WheelLevels - 1);
+}
+
+void emTask_WheelAdvanceFn(emType_Bits32 time)
+{
+	emType_Bits32 next;
+	while(emTask_WheelPending)
+	{
+		next = emTask_WheelNextFn();
+		if((emType_Sbits32)(next - time) > 0) break;
+		emTask_WheelTickFn(next);
+	}
+	emTask_WheelNow = time;
+	emType_StoreRelease(emTask_WheelNext, emTask_WheelPending? emTask_WheelNextFn() : time);
+}
+
+byte emTask_TimerAddFn(emTask_Mold256* task, emType_Bits32 deadline)
+{
+	emType_Bits32 now = emTask_Now();
+	if((emType_Sbits32)(deadline - now) <= 0) return 0xFF;
+	task->Deadline = deadline;
+	task->Status = emTask_StatusBlocked;
+	emTask_SchedLock();
+	if(emTask_WheelPending == 0) emTask_WheelNow = now;
+	emTask_WheelPutFn(task);
+	emType_StoreRelease(emTask_WheelNext, emTask_WheelNextFn());
+	emTask_SchedUnlock();
+	return 0;
+}
+
+void emTask_TimerPollFn()
+{
+	emTask_SchedLock();
+	emTask_WheelAdvanceFn(emTask_Now());
+	emTask_SchedUnlock();
+}
+
+emType_Bits32 emTask_TimerWaitFn()
+{
+	emType_Sbits32 wait;
+	if(emType_LoadAcquire(emTask_WheelPending) == 0) return emTask_Forever;
+	wait = (emType_Sbits32)(emType_LoadAcquire(emTask_WheelNext) - emTask_Now());
+	return (wait > 0)? (emType_Bits32)wait : 0;
+}
+
+#else
+byte emTask_WheelUnlinkFn(emTask_Mold256* task)
+{
+	(void)task;
+	return 0xFF;
+}
+
+byte emTask_TimerAddFn(emTask_Mold256* task, emType_Bits32 deadline)
+{
+	task->Deadline = deadline;
+	return 0xFF;
+}
+
+void emTask_TimerPollFn()
+{
+}
+
+emType_Bits32 emTask_TimerWaitFn()
+{
+	return emTask_Forever;
+}
 #endif
 
+#define	emTask_TimerAdd(task, deadline)	\
+	emTask_TimerAddFn((emTask_Mold256*)(task), (emType_Bits32)(deadline))
 
+#define	emTask_TimerPoll()	\
+	emTask_TimerPollFn()
 
-// Function:
-// Init(*task)
-// 
-// Initializes a task object (task) before use.
-// 
-// Parameters:
-// task:	the task object to initialize
-// 
-// Returns:
-// nothing
-//
-#define	emTask_Init(task)	\
-	do{	\
-		(*(task)).Line = 0;	\
-		(*(task)).Status = 0;	\
-	}while(0)
+#define	emTask_TimerWait()	\
+	emTask_TimerWaitFn()
 
 #if emTask_Shorthand >= 1
-#define	task_Init				emTask_Init
+#define	task_TimerAdd			emTask_TimerAdd
+#define	task_TimerPoll			emTask_TimerPoll
+#define	task_TimerWait			emTask_TimerWait
 #endif
 
 #if	emTask_Shorthand >= 2
-#define	tskInit					emTask_Init
+#define	tskTimerAdd				emTask_TimerAdd
+#define	tskTimerPoll			emTask_TimerPoll
+#define	tskTimerWait			emTask_TimerWait
 #endif
 
 
@@ -320,7 +1308,8 @@ void emTask_InitMain(void* task_list)
 // Function:
 // Add(*task, *taskfn)
 // 
-// Adds a new task to the list of tasks to be executed. 
+// Adds a new task to the list of tasks to be executed, and puts it in the ready
+// queue. The task object must have been initialized with Init().
 // 
 // Parameters:
 // task:	the task object for the task
@@ -331,7 +1320,15 @@ void emTask_InitMain(void* task_list)
 // 
 byte emTask_AddFn(void* task, emTask_FnPtr taskfn)
 {
-	return emList_Add(emTask, task, taskfn);
+	emTask_Mold256* tsk = (emTask_Mold256*)task;
+	byte status;
+	emTask_SchedLock();
+	status = emList_Add(emTask, &task, &taskfn);
+	emTask_SchedUnlock();
+	if(status) return 0xFF;
+	tsk->Fn = taskfn;
+	if(tsk->Queue == NULL) emTask_ReadyPushFn(tsk);
+	return 0;
 }
 
 #define	emTask_Add(task, taskfn)	\
@@ -350,7 +1347,13 @@ byte emTask_AddFn(void* task, emTask_FnPtr taskfn)
 // Function:
 // Remove(*task)
 // 
-// Removes an existing task from the list of tasks to be executed. 
+// Removes an existing task from the list of tasks to be executed, and from the
+// queue it is in (whether ready, or waiting on an event, semaphore, mutex or
+// condition). The order of remaining tasks in the list is preserved unless
+// emTask_UnorderedRemove is set. While workers are running, a task in the queue of
+// a worker is taken out under the lock of that worker, and a running task is
+// dropped by its worker when it returns, so the task object can be reused only
+// after RunWorkers() returns.
 // 
 // Parameters:
 // task:	the task object for the task to be removed
@@ -358,9 +1361,40 @@ byte emTask_AddFn(void* task, emTask_FnPtr taskfn)
 // Returns:
 // status:	0 for success, 0xFF for failed to add
 // 
+void emTask_DropFn(emTask_Mold256* task)
+{
+#if defined(emTask_Doorbell)
+	byte worker = emType_LoadAcquire(task->Worker);
+	// a running task (or one being made ready) is dropped by its worker
+	if(worker < emTask_MaxWorkers) emTask_WorkerDropFn(task, worker);
+	else if(worker == emTask_WorkerWaiting || emTask_Workers == 0)
+	{
+		if(emTask_WheelUnlinkFn(task)) emTask_QueueUnlinkFn(task);
+	}
+	emType_StoreRelease(task->Fn, (emTask_FnPtr)NULL);
+	if(emTask_Workers && emTask_GetNumTasks() == 0)
+	{
+		emTask_Done = 1;
+		emTask_RingFn();
+	}
+#else
+	if(emTask_WheelUnlinkFn(task)) emTask_QueueUnlinkFn(task);
+	task->Fn = NULL;
+#endif
+}
+
 byte emTask_Remove(void* task)
 {
-	return emList_Remove(emTask, task);
+	byte status;
+	emTask_SchedLock();
+#if emTask_UnorderedRemove
+	status = emList_RemoveUnordered(emTask, &task);
+#else
+	status = emList_Remove(emTask, &task);
+#endif
+	if(status == 0) emTask_DropFn((emTask_Mold256*)task);
+	emTask_SchedUnlock();
+	return status? 0xFF : 0;
 }
 
 #if emTask_Shorthand >= 1
@@ -386,9 +1420,16 @@ byte emTask_Remove(void* task)
 //
 void emTask_RemoveAll(byte exit_status)
 {
-	emList_Clear(emTask);
-	emTask_RunIndex = 0;
+	emTask_Mold256* task;
+	emTask_SchedLock();
 	emTask_ExitStatus = exit_status;
+	while(emTask_GetNumTasks())
+	{
+		task = (*emTask).Key[emTask_GetNumTasks() - 1];
+		(*emTask).Count--;
+		emTask_DropFn(task);
+	}
+	emTask_SchedUnlock();
 }
 
 #if emTask_Shorthand >= 1
@@ -401,10 +1442,74 @@ void emTask_RemoveAll(byte exit_status)
 
 
 
+// Function:
+// GetLatency(priority)
+// LatencyReset()
+// 
+// With Latency selected, the dispatch latency of a task (the time from when it is
+// made ready, till it is run) is measured each time it is run, and the worst-case
+// latency of each priority level is recorded (in microseconds, from Ticks()).
+// GetLatency() gives the worst-case latency of a level, and LatencyReset() clears
+// them all.
+// 
+// Parameters:
+// priority:	the priority level
+// 
+// Returns:
+// latency:		worst-case dispatch latency in microseconds (GetLatency())
+//
+#if emTask_Latency
+emType_Bits32	emTask_LatencyMax[emTask_Priorities];
+
+void emTask_LatencyNoteFn(emTask_Mold256* task)
+{
+	byte level = (task->Priority < emTask_Priorities)? task->Priority : emTask_Priorities - 1;
+	emType_Bits32 latency = emTask_Ticks() - task->Stamp, max;
+#if embd_Platform == embd_PlatformPC
+	do{
+		max = emType_LoadAcquire(emTask_LatencyMax[level]);
+		if(latency <= max) return;
+	}while(!emType_CompareSwap(emTask_LatencyMax[level], max, latency));
+#else
+	max = emTask_LatencyMax[level];
+	if(latency > max) emTask_LatencyMax[level] = latency;
+#endif
+}
+
+#define	emTask_GetLatency(priority)	\
+	emType_LoadAcquire(emTask_LatencyMax[priority])
+
+#define	emTask_LatencyReset()	\
+	memset(emTask_LatencyMax, 0, sizeof(emTask_LatencyMax))
+#else
+#define	emTask_LatencyNoteFn(task)
+#endif
+
+#if emTask_Shorthand >= 1
+#define	task_GetLatency			emTask_GetLatency
+#define	task_LatencyReset		emTask_LatencyReset
+#endif
+
+#if	emTask_Shorthand >= 2
+#define	tskGetLatency			emTask_GetLatency
+#define	tskLatencyReset			emTask_LatencyReset
+#endif
+
+
+
 // Function:
 // Run()
 // 
-// Executes all tasks and returns only when all tasks have been removed.
+// Executes all tasks and returns only when all tasks have been removed. Tasks
+// are executed from the highest priority level that has ready tasks, in FIFO
+// order (or in order of Deadline with EDF), and a task that returns is put back
+// in the ready queue, unless it is now waiting on an event (or has been
+// removed). Tasks of lower levels do not run while a higher level has ready
+// tasks, but a task polling with WaitWhile() waits in the lowest level. Tasks
+// waiting on an event are not executed until it is signalled, so each pass costs
+// time only for the ready tasks. When no task is ready, Run() waits for an event
+// to be posted (see Idle wait), or until the next sleeping task is due (see Timer
+// wheel).
 // 
 // Parameters:
 // none
@@ -412,13 +1517,34 @@ void emTask_RemoveAll(byte exit_status)
 // Returns:
 // status:	0 for success, 0xFF for failed
 // 
+void emTask_IdleFn()
+{
+#if defined(emTask_Doorbell)
+	std::unique_lock<std::mutex> lock(emTask_BellLock);
+	emType_Bits32 wait = emTask_TimerWaitFn();
+	std::chrono::steady_clock::time_point until = std::chrono::steady_clock::now() + std::chrono::milliseconds(wait);
+	while(emType_LoadAcquire(emTask_Posted) == NULL && wait)
+	{
+		if(wait == emTask_Forever) emTask_Bell.wait(lock);
+		else if(emTask_Bell.wait_until(lock, until) == std::cv_status::timeout) break;
+	}
+#else
+	emTask_IdleHook();
+#endif
+}
+
 byte emTask_Run()
 {
+	emTask_Mold256* task;
 	while(emTask_GetNumTasks())
 	{
-		if(emTask_RunIndex >= emTask_GetNumTasks()) emTask_RunIndex -= emTask_GetNumTasks();
-		(*emTask).Key[emTask_RunIndex]->Status = (*(*emTask).Value[emTask_RunIndex])((*emTask).Key[emTask_RunIndex]);
-		emTask_RunIndex++;
+		if(emType_LoadAcquire(emTask_Posted)) emTask_EventTakeFn();
+		if(emTask_TimerWaitFn() == 0) emTask_TimerPollFn();
+		task = emTask_ReadyTakeFn(&emTask_Ready);
+		if(task == NULL) { emTask_IdleFn(); continue; }
+		emTask_LatencyNoteFn(task);
+		task->Status = task->Fn(task);
+		if(task->Fn && task->Queue == NULL) emTask_ReadyPutFn(&emTask_Ready, task);
 	}
 	return emTask_ExitStatus;
 }
@@ -433,6 +1559,118 @@ byte emTask_Run()
 
 
 
+// Function:
+// RunWorkers(workers)
+// 
+// Executes all tasks on a number of worker threads (PC only), and returns only
+// when all tasks have been removed. The calling thread is used as worker 0. See
+// Workers for how tasks are shared among the workers. A task can be kept on a
+// worker by setting its Affinity (after Init()) to the worker number (a number
+// greater than the number of workers wraps around); by default, it is
+// emTask_AffinityAny. Tasks must not wait with WaitWhile() on data changed by a
+// task on another worker, unless the data is accessed atomically.
+// 
+// Parameters:
+// workers:		number of worker threads (including the calling thread)
+// 
+// Returns:
+// status:	0 for success, 0xFF for failed
+// 
+#if defined(emTask_Doorbell)
+byte emTask_WorkerIdleFn(byte worker)
+{
+	std::unique_lock<std::mutex> lock(emTask_BellLock);
+	emType_Bits32 wait = emTask_TimerWaitFn();
+	std::chrono::steady_clock::time_point until = std::chrono::steady_clock::now() + std::chrono::milliseconds(wait);
+	emTask_Sleepers++;
+	while(!emTask_Done && emTask_Worker[worker].Count == 0 && emTask_Stealable == 0 && emType_LoadAcquire(emTask_Posted) == NULL && wait)
+	{
+		if(wait == emTask_Forever) emTask_Bell.wait(lock);
+		else if(emTask_Bell.wait_until(lock, until) == std::cv_status::timeout) break;
+	}
+	emTask_Sleepers--;
+	return emTask_Done;
+}
+
+void emTask_WorkerFn(byte worker)
+{
+	emTask_Mold256* task;
+	emTask_FnPtr fn;
+	byte status;
+	emTask_Self = worker;
+	while(1)
+	{
+		if(emType_LoadAcquire(emTask_Posted)) emTask_EventTakeFn();
+		if(emTask_TimerWaitFn() == 0) emTask_TimerPollFn();
+		task = emTask_WorkerPopFn(worker);
+		if(task == NULL) task = emTask_WorkerStealFn(worker);
+		if(task == NULL)
+		{
+			if(emTask_WorkerIdleFn(worker)) break;
+			continue;
+		}
+		fn = emType_LoadAcquire(task->Fn);
+		if(fn == NULL) continue;
+		emTask_LatencyNoteFn(task);
+		status = fn(task);
+		// a task removed while it ran may have gone on to wait
+		if(emType_LoadAcquire(task->Fn) == NULL)
+		{
+			emTask_SchedLock();
+			emTask_DropFn(task);
+			emTask_SchedUnlock();
+			continue;
+		}
+		// a blocked task may already be running on another worker
+		if(status == emTask_StatusBlocked) continue;
+		task->Status = status;
+		if(emType_LoadAcquire(task->Fn) && task->Queue == NULL) emTask_WorkerPushFn(task, worker);
+	}
+}
+
+byte emTask_RunWorkers(byte workers)
+{
+	std::thread thread[emTask_MaxWorkers];
+	emTask_Mold256* task;
+	byte i, j;
+	if(workers < 1) workers = 1;
+	if(workers > emTask_MaxWorkers) workers = emTask_MaxWorkers;
+	for(i=0; i<workers; i++)
+	{
+		for(j=0; j<emTask_Priorities; j++)
+			emTask_EventInit(&emTask_Worker[i].Ready.Level[j]);
+		emTask_Worker[i].Ready.Map = 0;
+		emTask_Worker[i].Count = 0;
+	}
+	emTask_Stealable = 0;
+	emTask_Done = (emTask_GetNumTasks() == 0);
+	emTask_Workers = workers;
+	for(i=0; (task = emTask_ReadyTakeFn(&emTask_Ready)) != NULL; i++)
+		emTask_WorkerPushFn(task, i % workers);
+	for(i=1; i<workers; i++)
+		thread[i] = std::thread(emTask_WorkerFn, i);
+	emTask_WorkerFn(0);
+	for(i=1; i<workers; i++)
+		thread[i].join();
+	emTask_Workers = 0;
+	emTask_Self = 0;
+	for(i=0; i<workers; i++)
+		while((task = emTask_ReadyTakeFn(&emTask_Worker[i].Ready)) != NULL)
+			task->Worker = emTask_AffinityAny;
+	return emTask_ExitStatus;
+}
+#endif
+
+#if emTask_Shorthand >= 1
+#define	task_RunWorkers			emTask_RunWorkers
+#endif
+
+#if	emTask_Shorthand >= 2
+#define	tskRunWorkers			emTask_RunWorkers
+#endif
+
+
+
 // Macro:
 // TaskFn(taskname, taskmold)
 // 
@@ -751,7 +1989,9 @@ byte emTask_Run()
 // Function:
 // WaitWhile(waitcond, <state variables list>)
 // 
-// Used to wait while a condition is satisfied.
+// Used to wait while a condition is satisfied. While it waits, the task is kept
+// in the lowest priority level (see ReadyPut()), so that tasks of lower levels
+// still run, and it goes back to its own level once the condition is false.
 // 
 // Parameters:
 // waitcond:	wait condition (will wait as long as this condition is true)
@@ -804,6 +2044,137 @@ byte emTask_Run()
 
 
 
+// Function:
+// Block(*event)
+// 
+// Used to park the task on an event and switch from it. The task is not executed
+// again until the event is signalled, and then continues from the last continuation
+// line (the caller must have set it).
+// 
+// Parameters:
+// event:	the event to wait on
+// 
+// Returns:
+// nothing
+// 
+#define	emTask_Block(event)	\
+	do{	\
+	emTask_SchedLock();	\
+	(*emTask_Obj).Status = emTask_StatusBlocked;	\
+	emTask_QueuePushFn(event, (emTask_Mold256*)emTask_Obj);	\
+	emTask_SchedUnlock();	\
+	return emTask_StatusBlocked;	\
+	}while(0)
+
+#if emTask_Shorthand >= 1
+#define	task_Block				emTask_Block
+#endif
+
+#if	emTask_Shorthand >= 2
+#define	tskBlock				emTask_Block
+#endif
+
+
+
+// Function:
+// WaitEventWhile(*event, waitcond, <state variables list>)
+// WaitEventUntil(*event, waitcond, <state variables list>)
+// 
+// Used to wait while (or until) a condition is satisfied, where the condition can
+// only change when the event is signalled (or posted). Unlike WaitWhile(), the task
+// is parked on the event while it waits, and the condition is checked again only
+// after the event is signalled. While workers are running, the condition is checked
+// once more under the scheduler lock before parking, so a signal from another
+// worker is not missed.
+// 
+// Parameters:
+// event:		the event which is signalled when the condition may have changed
+// waitcond:	wait condition
+// <state variables list>:	a list of state variables (as type1, state1, type2, state2, ...) to store separated with commas
+// 
+// Returns:
+// nothing
+// 
+#define	emTask_WaitEventWhile(event, waitcond, ...)	\
+	do{	\
+	(*emTask_Obj).Line = __LINE__;	\
+	emTask_SaveState(__VA_ARGS__);	\
+	case __LINE__:	\
+	if(waitcond)	\
+	{	\
+		emTask_SchedLock();	\
+		if(!emTask_Workers || (waitcond))	\
+		{	\
+			(*emTask_Obj).Status = emTask_StatusBlocked;	\
+			emTask_QueuePushFn(event, (emTask_Mold256*)emTask_Obj);	\
+			emTask_SchedUnlock();	\
+			return emTask_StatusBlocked;	\
+		}	\
+		emTask_SchedUnlock();	\
+	}	\
+	emTask_LoadState(__VA_ARGS__);	\
+	}while(0)
+
+#define	emTask_WaitEventUntil(event, waitcond, ...)	\
+	emTask_WaitEventWhile(event, !(waitcond), __VA_ARGS__)
+
+#if emTask_Shorthand >= 1
+#define	task_WaitEventWhile		emTask_WaitEventWhile
+#define	task_WaitEventUntil		emTask_WaitEventUntil
+#endif
+
+#if	emTask_Shorthand >= 2
+#define	tskWaitEventWhile		emTask_WaitEventWhile
+#define	tskWaitEventUntil		emTask_WaitEventUntil
+#endif
+
+
+
+// Function:
+// WaitUntilDeadline(deadline, <state variables list>)
+// Sleep(ms, <state variables list>)
+// 
+// Used to sleep until the specified time (deadline, from Now()), or for the
+// specified number of milliseconds (ms). The task is kept in the timer wheel
+// while it sleeps, and is not executed till it expires (without the wheel, it
+// waits as with WaitWhile(), checking its deadline each time it is run). For a periodic task,
+// keep the deadline in a state variable and advance it by the period each time,
+// so that the period does not drift. With EDF, the task is then ordered among the
+// ready tasks of its level by this deadline, unless it sets another Deadline.
+// 
+// Parameters:
+// deadline:	time (in milliseconds) till which to sleep
+// ms:			number of milliseconds to sleep
+// <state variables list>:	a list of state variables (as type1, state1, type2, state2, ...) to store separated with commas
+// 
+// Returns:
+// nothing
+// 
+#define	emTask_WaitUntilDeadline(deadline, ...)	\
+	do{	\
+	(*emTask_Obj).Line = __LINE__;	\
+	emTask_SaveState(__VA_ARGS__);	\
+	if(emTask_TimerAddFn((emTask_Mold256*)emTask_Obj, (emType_Bits32)(deadline)) == 0) return emTask_StatusBlocked;	\
+	case __LINE__:	\
+	if(emTask_WheelLevels == 0 && (emType_Sbits32)((*emTask_Obj).Deadline - emTask_Now()) > 0) return emTask_StatusWaiting;	\
+	emTask_LoadState(__VA_ARGS__);	\
+	}while(0)
+
+#define	emTask_Sleep(ms, ...)	\
+	emTask_WaitUntilDeadline(emTask_Now() + (emType_Bits32)(ms), __VA_ARGS__)
+
+#if emTask_Shorthand >= 1
+#define	task_WaitUntilDeadline	emTask_WaitUntilDeadline
+#define	task_Sleep				emTask_Sleep
+#endif
+
+#if	emTask_Shorthand >= 2
+#define	tskWaitUntilDeadline	emTask_WaitUntilDeadline
+#define	tskSleep				emTask_Sleep
+#endif
+
+
+
 // Function:
 // Exit(exitstatus)
 // 
@@ -832,53 +2203,269 @@ byte emTask_Run()
 
 
 // Function:
+// SemInit(sem, count)
 // SemWait(sem, <state variables list>)
+// SemTryWait(sem)
+// SemSignal(sem)
 // 
-// Used to wait for a semaphore. Can be used to write a critical section.
+// Used to wait for, and signal with a semaphore. Can be used to write a critical
+// section, or to count resources. SemInit() initializes a semaphore with a number
+// of units (count). SemWait() takes a unit if one is available, or else parks the
+// task in the queue of the semaphore until SemSignal() hands a unit directly to it.
+// Waiting tasks are not executed, and get the units in FIFO order. SemTryWait()
+// takes a unit only if one is available, and does not wait. SemSignal() hands a
+// unit to the first waiting task (making it ready), or else adds it to the count.
+// These must only be used from tasks (or from the thread calling Run()). On PC,
+// a semaphore can be shared by tasks on different workers.
 // 
 // Parameters:
 // sem:			semaphore used
+// count:		initial number of units
 // <state variables list>:	a list of state variables (as type1, state1, type2, state2, ...) to store separated with commas
 // 
 // Returns:
-// nothing
+// status:		0 if a unit was taken, 0xFF if none available (SemTryWait())
 // 
+byte emTask_SemTakeFn(emTask_Semaphore* sem, emTask_Mold256* task)
+{
+	byte status = 0;
+	emTask_SchedLock();
+	if(sem->Count > 0) sem->Count--;
+	else
+	{
+		if(task)
+		{
+			task->Status = emTask_StatusBlocked;
+			emTask_QueuePushFn(&sem->Wait, task);
+		}
+		status = 0xFF;
+	}
+	emTask_SchedUnlock();
+	return status;
+}
+
+void emTask_SemGiveFn(emTask_Semaphore* sem)
+{
+	emTask_Mold256* task;
+	emTask_SchedLock();
+	task = emTask_QueuePopFn(&sem->Wait);
+	if(task == NULL) sem->Count++;
+	emTask_SchedUnlock();
+	if(task) emTask_ReadyPushFn(task);
+}
+
+#define	emTask_SemInit(sem, count)	\
+	do{	\
+		emTask_EventInit(&(sem).Wait);	\
+		(sem).Count = (count);	\
+	}while(0)
+
 #define	emTask_SemWait(sem, ...)	\
 	do{	\
-	emTask_WaitUntil(sem > 0, __VA_ARGS__);	\
-	sem--;	\
+	(*emTask_Obj).Line = __LINE__;	\
+	emTask_SaveState(__VA_ARGS__);	\
+	if(emTask_SemTakeFn(&(sem), (emTask_Mold256*)emTask_Obj)) return emTask_StatusBlocked;	\
+	case __LINE__:	\
+	emTask_LoadState(__VA_ARGS__);	\
 	}while(0)
 
+#define	emTask_SemTryWait(sem)	\
+	emTask_SemTakeFn(&(sem), NULL)
+
+#define	emTask_SemSignal(sem)	\
+	emTask_SemGiveFn(&(sem))
+
 #if emTask_Shorthand >= 1
+#define	task_SemInit			emTask_SemInit
 #define	task_SemWait			emTask_SemWait
+#define	task_SemTryWait			emTask_SemTryWait
+#define	task_SemSignal			emTask_SemSignal
 #endif
 
 #if	emTask_Shorthand >= 2
+#define	tskSemInit				emTask_SemInit
 #define	tskSemWait				emTask_SemWait
+#define	tskSemTryWait			emTask_SemTryWait
+#define	tskSemSignal			emTask_SemSignal
 #endif
 
 
 
 // Function:
-// SemSignal(sem)
+// MutexInit(mutex)
+// MutexLock(mutex, <state variables list>)
+// MutexUnlock(mutex)
 // 
-// Used to signal with a semaphore. Can be used to write a critical section.
+// Used to lock and unlock a mutex. MutexInit() initializes a mutex (unlocked).
+// MutexLock() makes the task the owner of the mutex if it is unlocked, or else
+// parks the task in the queue of the mutex until it is handed the mutex.
+// MutexUnlock() hands the mutex directly to the first waiting task (making it
+// ready), or else unlocks it. Waiting tasks are not executed, and get the mutex in
+// FIFO order. These must only be used from tasks.
 // 
 // Parameters:
-// sem:			semaphore used
+// mutex:		mutex used
+// <state variables list>:	a list of state variables (as type1, state1, type2, state2, ...) to store separated with commas
 // 
 // Returns:
-// nothing
+// status:		0 for success, 0xFF if mutex was not locked (MutexUnlock())
 // 
-#define	emTask_SemSignal(sem)	\
-	sem++
+byte emTask_MutexTakeFn(emTask_Mutex* mutex, emTask_Mold256* task)
+{
+	byte status = 0;
+	emTask_SchedLock();
+	if(mutex->Owner == NULL) mutex->Owner = task;
+	else
+	{
+		task->Status = emTask_StatusBlocked;
+		emTask_QueuePushFn(&mutex->Wait, task);
+		status = 0xFF;
+	}
+	emTask_SchedUnlock();
+	return status;
+}
+
+emTask_Mold256* emTask_MutexPassFn(emTask_Mutex* mutex)
+{
+	emTask_Mold256* task = emTask_QueuePopFn(&mutex->Wait);
+	mutex->Owner = task;
+	return task;
+}
+
+byte emTask_MutexGiveFn(emTask_Mutex* mutex)
+{
+	emTask_Mold256* task;
+	emTask_SchedLock();
+	if(mutex->Owner == NULL)
+	{
+		emTask_SchedUnlock();
+		return 0xFF;
+	}
+	task = emTask_MutexPassFn(mutex);
+	emTask_SchedUnlock();
+	if(task) emTask_ReadyPushFn(task);
+	return 0;
+}
+
+#define	emTask_MutexInit(mutex)	\
+	do{	\
+		emTask_EventInit(&(mutex).Wait);	\
+		(mutex).Owner = NULL;	\
+	}while(0)
+
+#define	emTask_MutexLock(mutex, ...)	\
+	do{	\
+	(*emTask_Obj).Line = __LINE__;	\
+	emTask_SaveState(__VA_ARGS__);	\
+	if(emTask_MutexTakeFn(&(mutex), (emTask_Mold256*)emTask_Obj)) return emTask_StatusBlocked;	\
+	case __LINE__:	\
+	emTask_LoadState(__VA_ARGS__);	\
+	}while(0)
+
+#define	emTask_MutexUnlock(mutex)	\
+	emTask_MutexGiveFn(&(mutex))
 
 #if emTask_Shorthand >= 1
-#define	task_SemSignal			emTask_SemSignal
+#define	task_MutexInit			emTask_MutexInit
+#define	task_MutexLock			emTask_MutexLock
+#define	task_MutexUnlock		emTask_MutexUnlock
 #endif
 
 #if	emTask_Shorthand >= 2
-#define	tskSemSignal			emTask_SemSignal
+#define	tskMutexInit			emTask_MutexInit
+#define	tskMutexLock			emTask_MutexLock
+#define	tskMutexUnlock			emTask_MutexUnlock
+#endif
+
+
+
+// Function:
+// CondInit(cond)
+// CondWait(cond, mutex, <state variables list>)
+// CondSignal(cond)
+// CondBroadcast(cond)
+// 
+// Used to wait on a condition. CondInit() initializes a condition. CondWait()
+// unlocks the mutex (which the task must own) and parks the task in the queue of the
+// condition, in one step. CondSignal() moves the first waiting task to the queue of
+// the mutex, or makes it ready and its owner if it is unlocked, and CondBroadcast()
+// moves all of them; so a task continues after CondWait() only once it owns the
+// mutex again, and woken tasks do not contend for it. As the condition may have
+// changed again by then, it should be checked again after CondWait(). These must
+// only be used from tasks, and the same mutex must be used with all waits on a
+// condition.
+// 
+// Parameters:
+// cond:		condition used
+// mutex:		mutex which protects the condition
+// <state variables list>:	a list of state variables (as type1, state1, type2, state2, ...) to store separated with commas
+// 
+// Returns:
+// status:		0 if a task was woken, 0xFF if none was waiting (CondSignal())
+// 
+void emTask_CondParkFn(emTask_Cond* cond, emTask_Mutex* mutex, emTask_Mold256* task)
+{
+	emTask_Mold256* next;
+	emTask_SchedLock();
+	cond->Mutex = mutex;
+	task->Status = emTask_StatusBlocked;
+	emTask_QueuePushFn(&cond->Wait, task);
+	next = emTask_MutexPassFn(mutex);
+	emTask_SchedUnlock();
+	if(next) emTask_ReadyPushFn(next);
+}
+
+byte emTask_CondSignalFn(emTask_Cond* cond)
+{
+	emTask_Mold256* task, * ready = NULL;
+	emTask_SchedLock();
+	task = emTask_QueuePopFn(&cond->Wait);
+	if(task && cond->Mutex->Owner) emTask_QueuePushFn(&cond->Mutex->Wait, task);
+	else if(task) ready = cond->Mutex->Owner = task;
+	emTask_SchedUnlock();
+	if(ready) emTask_ReadyPushFn(ready);
+	return task? 0 : 0xFF;
+}
+
+void emTask_CondBroadcastFn(emTask_Cond* cond)
+{
+	while(emTask_CondSignalFn(cond) == 0);
+}
+
+#define	emTask_CondInit(cond)	\
+	do{	\
+		emTask_EventInit(&(cond).Wait);	\
+		(cond).Mutex = NULL;	\
+	}while(0)
+
+#define	emTask_CondWait(cond, mutex, ...)	\
+	do{	\
+	(*emTask_Obj).Line = __LINE__;	\
+	emTask_SaveState(__VA_ARGS__);	\
+	emTask_CondParkFn(&(cond), &(mutex), (emTask_Mold256*)emTask_Obj);	\
+	return emTask_StatusBlocked;	\
+	case __LINE__:	\
+	emTask_LoadState(__VA_ARGS__);	\
+	}while(0)
+
+#define	emTask_CondSignal(cond)	\
+	emTask_CondSignalFn(&(cond))
+
+#define	emTask_CondBroadcast(cond)	\
+	emTask_CondBroadcastFn(&(cond))
+
+#if emTask_Shorthand >= 1
+#define	task_CondInit			emTask_CondInit
+#define	task_CondWait			emTask_CondWait
+#define	task_CondSignal			emTask_CondSignal
+#define	task_CondBroadcast		emTask_CondBroadcast
+#endif
+
+#if	emTask_Shorthand >= 2
+#define	tskCondInit				emTask_CondInit
+#define	tskCondWait				emTask_CondWait
+#define	tskCondSignal			emTask_CondSignal
+#define	tskCondBroadcast		emTask_CondBroadcast
 #endif
 
 
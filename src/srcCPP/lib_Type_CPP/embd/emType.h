@@ -43,6 +43,44 @@
 
 
 
+// SIMD support
+// 
+// On PC platform (x86), SIMD instruction sets available at compile
+// time are used to speed up operations on wider data. emType_SSE2,
+// emType_SSSE3 and emType_AVX2 are defined when the respective
+// instruction set is available. With GCC / Clang on x86, the
+// hot kernels are additionally built for each instruction set
+// and selected at run time (emType_Dispatch), so that a generic
+// build still makes use of the CPU it runs on.
+#if embd_Platform == embd_PlatformPC
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define	emType_SSE2			1
+#include <emmintrin.h>
+#endif
+#if defined(__SSSE3__) || defined(__AVX2__)
+#define	emType_SSSE3		1
+#include <tmmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define	emType_AVX2			1
+#include <immintrin.h>
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define	emType_Dispatch		1
+#include <immintrin.h>
+#define	emType_TargetSse2	__attribute__((target("sse2")))
+#define	emType_TargetSsse3	__attribute__((target("ssse3")))
+#define	emType_TargetAvx2	__attribute__((target("avx2")))
+#endif
+#endif
+#if !defined(emType_Dispatch)
+#define	emType_TargetSse2
+#define	emType_TargetSsse3
+#define	emType_TargetAvx2
+#endif
+
+
+
 // Select shorthand level
 // 
 // The default shorthand level is 3 i.e., members of this
@@ -123,6 +161,61 @@ typedef long long			int64;
 typedef unsigned long long	uint64;
 typedef char*				string;
 
+// exact 32-bit word (long is 64-bit on some PC platforms)
+#if embd_Platform == embd_PlatformPC
+typedef unsigned int		emType_Bits32;
+typedef signed int			emType_Sbits32;
+#else
+typedef unsigned long		emType_Bits32;
+typedef signed long			emType_Sbits32;
+#endif
+
+
+
+// Atomic access
+// 
+// LoadAcquire() and StoreRelease() read and write a variable shared
+// between threads (or between an interrupt and the main program) with
+// acquire / release ordering. On AVR (single core), a volatile access
+// is sufficient for variables of 1 byte. CompareSwap() atomically
+// replaces a 32-bit variable with desired value, only if it is equal to
+// expected value, and returns TRUE if it did (PC only). CacheLine is the
+// size of a cache line, used to keep data written by different threads
+// apart.
+#if embd_Platform == embd_PlatformPC && defined(__GNUC__)
+#define	emType_LoadAcquire(var)				__atomic_load_n(&(var), __ATOMIC_ACQUIRE)
+#define	emType_StoreRelease(var, value)		__atomic_store_n(&(var), (value), __ATOMIC_RELEASE)
+#define	emType_CompareSwap(var, expected, desired)	\
+	__sync_bool_compare_and_swap(&(var), (expected), (desired))
+#define	emType_CacheLine					64
+#elif embd_Platform == embd_PlatformPC
+// volatile accesses have acquire / release semantics with MSVC (/volatile:ms)
+#include <intrin.h>
+#define	emType_LoadAcquire(var)				(*(volatile decltype(var)*)&(var))
+#define	emType_StoreRelease(var, value)		((*(volatile decltype(var)*)&(var)) = (value))
+#define	emType_CompareSwap(var, expected, desired)	\
+	(_InterlockedCompareExchange((volatile long*)&(var), (long)(desired), (long)(expected)) == (long)(expected))
+#define	emType_CacheLine					64
+#else
+#define	emType_LoadAcquire(var)				(*(volatile typeof(var)*)&(var))
+#define	emType_StoreRelease(var, value)		((*(volatile typeof(var)*)&(var)) = (value))
+#define	emType_CacheLine					1
+#endif
+
+#if emType_Shorthand >= 1
+#define	type_LoadAcquire		emType_LoadAcquire
+#define	type_StoreRelease		emType_StoreRelease
+#define	type_CompareSwap		emType_CompareSwap
+#define	type_CacheLine			emType_CacheLine
+#endif
+
+#if	emType_Shorthand >= 2
+#define	typLoadAcquire			emType_LoadAcquire
+#define	typStoreRelease			emType_StoreRelease
+#define	typCompareSwap			emType_CompareSwap
+#define	typCacheLine			emType_CacheLine
+#endif
+
 
 
 // Type Mold format
@@ -216,13 +309,40 @@ emType_MoldMake(256);
 
 
 
+// Thread-local storage
+// 
+// On PC, ThreadLocal gives each thread its own copy of a global variable, so
+// that functions using the internal type object can be used from several
+// threads at once. On AVR (single thread) it has no effect.
+#if embd_Platform == embd_PlatformPC && defined(__cplusplus) && __cplusplus >= 201103L
+#define	emType_ThreadLocal		thread_local
+#elif embd_Platform == embd_PlatformPC && defined(_MSC_VER)
+#define	emType_ThreadLocal		__declspec(thread)
+#elif embd_Platform == embd_PlatformPC && defined(__GNUC__)
+#define	emType_ThreadLocal		__thread
+#else
+#define	emType_ThreadLocal
+#endif
+
+#if emType_Shorthand >= 1
+#define	type_ThreadLocal		emType_ThreadLocal
+#endif
+
+#if	emType_Shorthand >= 2
+#define	typThreadLocal			emType_ThreadLocal
+#endif
+
+
+
 // Internal Type object
 // 
 // emType has an internal type object used for type conversions. It can be used
 // through functions provided in this library, and can also be accessed manually
-// as "emType".
+// as "emType". Each thread has its own internal type object. Functions which take
+// a source / destination address (src / dst) do not use it, and can be used from
+// anywhere (including interrupts).
 // 
-emType_Mold	emType;
+emType_ThreadLocal emType_Mold	emType;
 
 
 
@@ -998,10 +1118,12 @@ void emType_PutStringExtFn(char* dst, int off, string value, byte opt)
 // To<type>(smaller_data_types)
 // 
 // Assembles smaller data types to a bigger data type. The
-// assembling is done in little endian format, which means
-// that the smaller data representing the least significant
-// part should come first, and the smaller data representing
-// the most significant part should come last.
+// smaller data are given from the most significant part to
+// the least significant part (the last one is the least
+// significant). The parts are combined with shifts in
+// registers (no memory is used), so the result is a constant
+// expression for constant parts, and adjacent bytes from
+// memory compile to a single load (or byte swap).
 // 
 // Parameters:
 // smaller_data_types:	list of bytes, shorts, ints, etc.
@@ -1033,17 +1155,37 @@ void emType_PutStringExtFn(char* dst, int off, string value, byte opt)
 #define	emType_ToChar(...)	\
 	Macro((char)emType_ToByte(__VA_ARGS__))
 
-#define	emType_ToType2(var, ret, rtype, dat1, dat0)	\
-	(((emType.var[0] = (dat0)) & (emType.var[1] = (dat1)) & 0)? (rtype)0 : emType.ret[0])
+#define	emType_ToBits32Srt(ushort1, ushort0)	\
+	((((emType_Bits32)(ushort)(ushort1)) << 16) | (emType_Bits32)(ushort)(ushort0))
+
+#define	emType_ToBits32Byt(byte3, byte2, byte1, byte0)	\
+	((((emType_Bits32)(byte)(byte3)) << 24) | (((emType_Bits32)(byte)(byte2)) << 16) | (((emType_Bits32)(byte)(byte1)) << 8) | (emType_Bits32)(byte)(byte0))
 
-#define	emType_ToType4(var, ret, rtype, dat3, dat2, dat1, dat0)	\
-	(((emType.var[0] = (dat0)) & (emType.var[1] = (dat1)) & (emType.var[2] = (dat2)) & (emType.var[3] = (dat3)) & 0)? (rtype)0 : emType.ret[0])
+#define	emType_ToBits64Lng(ulong1, ulong0)	\
+	((((uint64)(emType_Bits32)(ulong1)) << 32) | (uint64)(emType_Bits32)(ulong0))
 
-#define emType_ToType8(var, ret, rtype, dat7, dat6, dat5, dat4, dat3, dat2, dat1, dat0)	\
-	(((emType.var[0] = (dat0)) & (emType.var[1] = (dat1)) & (emType.var[2] = (dat2)) & (emType.var[3] = (dat3)) & (emType.var[4] = (dat4)) & (emType.var[5] = (dat5)) & (emType.var[6] = (dat6)) & (emType.var[7] = (dat7)) & 0)? (rtype)0 : emType.ret[0])
+#define	emType_ToBits64Srt(ushort3, ushort2, ushort1, ushort0)	\
+	emType_ToBits64Lng(emType_ToBits32Srt(ushort3, ushort2), emType_ToBits32Srt(ushort1, ushort0))
+
+#define	emType_ToBits64Byt(byte7, byte6, byte5, byte4, byte3, byte2, byte1, byte0)	\
+	emType_ToBits64Lng(emType_ToBits32Byt(byte7, byte6, byte5, byte4), emType_ToBits32Byt(byte3, byte2, byte1, byte0))
+
+static inline float emType_BitsToFloat(emType_Bits32 bits)
+{
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+static inline double emType_BitsToDouble(uint64 bits)
+{
+	double value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
 
 #define	emType_ToShort(byte1, byte0)	\
-	((short)(((byte1) << 8) | byte0))
+	((short)((((ushort)(byte)(byte1)) << 8) | (byte)(byte0)))
 
 #define	emType_ToUshort(...)	\
 	Macro((ushort)emType_ToShort(__VA_ARGS__))
@@ -1055,43 +1197,43 @@ void emType_PutStringExtFn(char* dst, int off, string value, byte opt)
 	emType_ToUshort
 
 #define	emType_ToInt32Srt(ushort1, ushort0)	\
-	emType_ToType2(Ushort, Int32, int32, ushort1, ushort0)
+	((int32)(emType_Sbits32)emType_ToBits32Srt(ushort1, ushort0))
 
 #define	emType_ToInt32Byt(byte3, byte2, byte1, byte0)	\
-	emType_ToType2(Byte, Int32, int32, byte3, byte2, byte1, byte0)
+	((int32)(emType_Sbits32)emType_ToBits32Byt(byte3, byte2, byte1, byte0))
 
 #define	emType_ToInt32(...)	\
 	Macro(Macro4(__VA_ARGS__, emType_ToInt32Byt, _3, emType_ToInt32Srt)(__VA_ARGS__))
 
 #define	emType_ToUint32Srt(ushort1, ushort0)	\
-	emType_ToType2(Ushort, Uint32, uint32, ushort1, ushort0)
+	((uint32)emType_ToBits32Srt(ushort1, ushort0))
 
 #define	emType_ToUint32Byt(byte3, byte2, byte1, byte0)	\
-	emType_ToType2(Byte, Uint32, uint32, byte3, byte2, byte1, byte0)
+	((uint32)emType_ToBits32Byt(byte3, byte2, byte1, byte0))
 
 #define	emType_ToUint32(...)	\
 	Macro(Macro4(__VA_ARGS__, emType_ToUint32Byt, _3, emType_ToUint32Srt)(__VA_ARGS__))
 
 #define	emType_ToInt64Lng(ulong1, ulong0)	\
-	emType_ToType2(Ulong, Int64, int64, ulong1, ulong0)
+	((int64)emType_ToBits64Lng(ulong1, ulong0))
 
 #define	emType_ToInt64Srt(ushort3, ushort2, ushort1, ushort0)	\
-	emType_ToType4(Ushort, Int64, int64, ushort3, ushort2, ushort1, ushort0)
+	((int64)emType_ToBits64Srt(ushort3, ushort2, ushort1, ushort0))
 
 #define	emType_ToInt64Byt(byte7, byte6, byte5, byte4, byte3, byte2, byte1, byte0)	\
-	emType_ToType8(Byte, Int64, int64, byte7, byte6, byte5, byte4, byte3, byte2, byte1, byte0)
+	((int64)emType_ToBits64Byt(byte7, byte6, byte5, byte4, byte3, byte2, byte1, byte0))
 
 #define	emType_ToInt64(...)	\
 	Macro(Macro8(__VA_ARGS__, emType_ToInt64Byt, _7, _6, _5, emType_ToInt64Srt, _3, emType_ToInt64Lng)(__VA_ARGS__))
 
 #define	emType_ToUint64Lng(ulong1, ulong0)	\
-	emType_ToType2(Ulong, Uint64, uint64, ulong1, ulong0)
+	((uint64)emType_ToBits64Lng(ulong1, ulong0))
 
 #define	emType_ToUint64Srt(ushort3, ushort2, ushort1, ushort0)	\
-	emType_ToType4(Ushort, Uint64, uint64, ushort3, ushort2, ushort1, ushort0)
+	((uint64)emType_ToBits64Srt(ushort3, ushort2, ushort1, ushort0))
 
 #define	emType_ToUint64Byt(byte7, byte6, byte5, byte4, byte3, byte2, byte1, byte0)	\
-	emType_ToType8(Byte, Uint64, uint64, byte7, byte6, byte5, byte4, byte3, byte2, byte1, byte0)
+	((uint64)emType_ToBits64Byt(byte7, byte6, byte5, byte4, byte3, byte2, byte1, byte0))
 
 #define	emType_ToUint64(...)	\
 	Macro(Macro8(__VA_ARGS__, emType_ToUint64Byt, _7, _6, _5, emType_ToUint64Srt, _3, emType_ToUint64Lng)(__VA_ARGS__))
@@ -1111,22 +1253,22 @@ void emType_PutStringExtFn(char* dst, int off, string value, byte opt)
 #endif
 
 #define	emType_ToFloatSrt(ushort1, ushort0)	\
-	emType_ToType2(Ushort, Float, float, ushort1, ushort0)
+	emType_BitsToFloat(emType_ToBits32Srt(ushort1, ushort0))
 
 #define	emType_ToFloatByt(byte3, byte2, byte1, byte0)	\
-	emType_ToType4(Byte, Float, float, byte3, byte2, byte1, byte0)
+	emType_BitsToFloat(emType_ToBits32Byt(byte3, byte2, byte1, byte0))
 
 #define	emType_ToFloat(...)	\
 	Macro(Macro4(__VA_ARGS__, emType_ToFloatByt, _3, emType_ToFloatSrt)(__VA_ARGS__))
 
 #define	emType_ToDoubleUlong32(ulong32_1, ulong32_0)	\
-	emType_ToType2(Uint, Double, double, ulong32_1, ulong32_0)
+	emType_BitsToDouble(emType_ToBits64Lng(ulong32_1, ulong32_0))
 
 #define	emType_ToDoubleSrt(ushort3, ushort2, ushort1, ushort0)	\
-	emType_ToType4(Ushort, Double, double, ushort3, ushort2, ushort1, ushort0)
+	emType_BitsToDouble(emType_ToBits64Srt(ushort3, ushort2, ushort1, ushort0))
 
 #define	emType_ToDoubleByt(byte7, byte6, byte5, byte4, byte3, byte2, byte1, byte0)	\
-	emType_ToType8(Byte, Double, double, byte7, byte6, byte5, byte4, byte3, byte2, byte1, byte0)
+	emType_BitsToDouble(emType_ToBits64Byt(byte7, byte6, byte5, byte4, byte3, byte2, byte1, byte0))
 
 #define	emType_ToDouble(...)	\
 	Macro(Macro8(__VA_ARGS__, emType_ToDoubleByt, _7, _6, _5, emType_ToDoubleSrt, _3, emType_ToDoubleUlong32)(__VA_ARGS__))
@@ -1201,229 +1343,2700 @@ void emType_PutStringExtFn(char* dst, int off, string value, byte opt)
 #endif
 
 
-
 // Function:
-// DoReverse(*src, off, len)
-// DoReverse(off, len)
+// Get<type><BE/LE>(*src, off)
+// Get<type><BE/LE>(off)
+// Put<type><BE/LE>(*dst, off, value)
+// Put<type><BE/LE>(off, value)
 // 
-// Reverses the data stored at the source address (src + off)
-// of specified length (len). The data at the source is directly
-// reversed, and hence if the original data is required, then
-// it is suggested to make a copy of it. If source base address
-// is not specified, this library's internal buffer is assumed
-// as the source base address.
+// Returns / stores the <type> value at the specified address with offset
+// (src + off or dst + off), in big endian (BE) or little endian (LE) byte
+// order, whatever be the byte order of the platform. The value is loaded /
+// stored with a single (unaligned) memory access, and its bytes are swapped
+// in register if required (bswap / movbe on x86). If address is not
+// specified, then this library's internal buffer is used.
 // 
 // Parameters:
-// src:		the base address of source data
-// off:		offset to the actual data to be reversed (src + off)
-// len:		length of data to be reversed
+// src:		the base address of stored data
+// dst:		the base address of destination
+// off:		offset of the <type> value
+// value:	the value of <type> to be stored
 // 
 // Returns:
-// nothing
+// <type>_value:	the value of the specified <type> (for Get)
 // 
-void emType_DoReverseExtFn(byte* src, int off, int len)
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define	emType_LittleEndian		0
+#else
+#define	emType_LittleEndian		1
+#endif
+
+#if defined(__GNUC__)
+#define	emType_Swap16(x)		__builtin_bswap16(x)
+#define	emType_Swap32(x)		__builtin_bswap32(x)
+#define	emType_Swap64(x)		__builtin_bswap64(x)
+#elif defined(_MSC_VER)
+#include <stdlib.h>
+#define	emType_Swap16(x)		_byteswap_ushort(x)
+#define	emType_Swap32(x)		_byteswap_ulong(x)
+#define	emType_Swap64(x)		_byteswap_uint64(x)
+#else
+#define	emType_Swap16(x)		((uint16)((((uint16)(x)) << 8) | (((uint16)(x)) >> 8)))
+#define	emType_Swap32(x)		emType_ToBits32Srt(emType_Swap16((uint16)(x)), emType_Swap16((uint16)((x) >> 16)))
+#define	emType_Swap64(x)		emType_ToBits64Lng(emType_Swap32((emType_Bits32)(x)), emType_Swap32((emType_Bits32)((x) >> 32)))
+#endif
+
+#if emType_LittleEndian
+#define	emType_SwapLE16(x)		((uint16)(x))
+#define	emType_SwapLE32(x)		((emType_Bits32)(x))
+#define	emType_SwapLE64(x)		((uint64)(x))
+#define	emType_SwapBE16(x)		emType_Swap16(x)
+#define	emType_SwapBE32(x)		emType_Swap32(x)
+#define	emType_SwapBE64(x)		emType_Swap64(x)
+#else
+#define	emType_SwapLE16(x)		emType_Swap16(x)
+#define	emType_SwapLE32(x)		emType_Swap32(x)
+#define	emType_SwapLE64(x)		emType_Swap64(x)
+#define	emType_SwapBE16(x)		((uint16)(x))
+#define	emType_SwapBE32(x)		((emType_Bits32)(x))
+#define	emType_SwapBE64(x)		((uint64)(x))
+#endif
+
+static inline uint16 emType_LoadBits16(byte* src)
 {
-	byte byt, *end;
-	for(src += off, end=src+len-1; src<end; src++, end--)
-	{
-		byt = *src;
-		*src = *end;
-		*end = byt;
-	}
+	uint16 value;
+	memcpy(&value, src, sizeof(value));
+	return value;
 }
 
-#define	emType_DoReverseExt(src, off, len)	\
-	emType_DoReverseExt((byte*)(src), (int)(off), (int)(len))
+static inline emType_Bits32 emType_LoadBits32(byte* src)
+{
+	emType_Bits32 value;
+	memcpy(&value, src, sizeof(value));
+	return value;
+}
 
-#define	emType_DoReverseInt(off, len)	\
-	emType_DoReverseExt(&emType, off, len)
+static inline uint64 emType_LoadBits64(byte* src)
+{
+	uint64 value;
+	memcpy(&value, src, sizeof(value));
+	return value;
+}
 
-#define	emType_DoReverse(...)	\
-	Macro(Macro3(__VA_ARGS__, emType_DoReverseExt, emType_DoReverseInt)(__VA_ARGS__))
+static inline void emType_StoreBits16(byte* dst, uint16 value)
+{
+	memcpy(dst, &value, sizeof(value));
+}
+
+static inline void emType_StoreBits32(byte* dst, emType_Bits32 value)
+{
+	memcpy(dst, &value, sizeof(value));
+}
+
+static inline void emType_StoreBits64(byte* dst, uint64 value)
+{
+	memcpy(dst, &value, sizeof(value));
+}
+
+static inline emType_Bits32 emType_FloatToBits(float value)
+{
+	emType_Bits32 bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+static inline uint64 emType_DoubleToBits(double value)
+{
+	uint64 bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+#define	emType_GetOrderExt(conv, bits, order, src, off)	\
+	conv(emType_Swap##order##bits(emType_LoadBits##bits(((byte*)(src)) + (off))))
+
+#define	emType_GetOrderInt(conv, bits, order, off)	\
+	emType_GetOrderExt(conv, bits, order, &emType, off)
+
+#define	emType_GetOrder(...)	\
+	Macro(Macro5(__VA_ARGS__, emType_GetOrderExt, emType_GetOrderInt)(__VA_ARGS__))
+
+#define	emType_PutOrderExt(conv, bits, order, dst, off, value)	\
+	emType_StoreBits##bits(((byte*)(dst)) + (off), emType_Swap##order##bits(conv(value)))
+
+#define	emType_PutOrderInt(conv, bits, order, off, value)	\
+	emType_PutOrderExt(conv, bits, order, &emType, off, value)
+
+#define	emType_PutOrder(...)	\
+	Macro(Macro6(__VA_ARGS__, emType_PutOrderExt, emType_PutOrderInt)(__VA_ARGS__))
+
+#define	emType_GetShortBE(...)	\
+	Macro(emType_GetOrder((short), 16, BE, __VA_ARGS__))
+
+#define	emType_GetShortLE(...)	\
+	Macro(emType_GetOrder((short), 16, LE, __VA_ARGS__))
+
+#define	emType_GetUshortBE(...)	\
+	Macro(emType_GetOrder((ushort), 16, BE, __VA_ARGS__))
+
+#define	emType_GetUshortLE(...)	\
+	Macro(emType_GetOrder((ushort), 16, LE, __VA_ARGS__))
+
+#define	emType_GetInt16BE(...)	\
+	Macro(emType_GetOrder((int16), 16, BE, __VA_ARGS__))
+
+#define	emType_GetInt16LE(...)	\
+	Macro(emType_GetOrder((int16), 16, LE, __VA_ARGS__))
+
+#define	emType_GetUint16BE(...)	\
+	Macro(emType_GetOrder((uint16), 16, BE, __VA_ARGS__))
+
+#define	emType_GetUint16LE(...)	\
+	Macro(emType_GetOrder((uint16), 16, LE, __VA_ARGS__))
+
+#define	emType_GetInt32BE(...)	\
+	Macro(emType_GetOrder((int32)(emType_Sbits32), 32, BE, __VA_ARGS__))
+
+#define	emType_GetInt32LE(...)	\
+	Macro(emType_GetOrder((int32)(emType_Sbits32), 32, LE, __VA_ARGS__))
+
+#define	emType_GetUint32BE(...)	\
+	Macro(emType_GetOrder((uint32), 32, BE, __VA_ARGS__))
+
+#define	emType_GetUint32LE(...)	\
+	Macro(emType_GetOrder((uint32), 32, LE, __VA_ARGS__))
+
+#define	emType_GetInt64BE(...)	\
+	Macro(emType_GetOrder((int64), 64, BE, __VA_ARGS__))
+
+#define	emType_GetInt64LE(...)	\
+	Macro(emType_GetOrder((int64), 64, LE, __VA_ARGS__))
+
+#define	emType_GetUint64BE(...)	\
+	Macro(emType_GetOrder((uint64), 64, BE, __VA_ARGS__))
+
+#define	emType_GetUint64LE(...)	\
+	Macro(emType_GetOrder((uint64), 64, LE, __VA_ARGS__))
+
+#define	emType_GetFloatBE(...)	\
+	Macro(emType_GetOrder(emType_BitsToFloat, 32, BE, __VA_ARGS__))
+
+#define	emType_GetFloatLE(...)	\
+	Macro(emType_GetOrder(emType_BitsToFloat, 32, LE, __VA_ARGS__))
+
+#define	emType_GetDoubleBE(...)	\
+	Macro(emType_GetOrder(emType_BitsToDouble, 64, BE, __VA_ARGS__))
+
+#define	emType_GetDoubleLE(...)	\
+	Macro(emType_GetOrder(emType_BitsToDouble, 64, LE, __VA_ARGS__))
+
+#define	emType_PutShortBE(...)	\
+	Macro(emType_PutOrder((uint16), 16, BE, __VA_ARGS__))
+
+#define	emType_PutShortLE(...)	\
+	Macro(emType_PutOrder((uint16), 16, LE, __VA_ARGS__))
+
+#define	emType_PutUshortBE(...)	\
+	Macro(emType_PutOrder((uint16), 16, BE, __VA_ARGS__))
+
+#define	emType_PutUshortLE(...)	\
+	Macro(emType_PutOrder((uint16), 16, LE, __VA_ARGS__))
+
+#define	emType_PutInt16BE(...)	\
+	Macro(emType_PutOrder((uint16), 16, BE, __VA_ARGS__))
+
+#define	emType_PutInt16LE(...)	\
+	Macro(emType_PutOrder((uint16), 16, LE, __VA_ARGS__))
+
+#define	emType_PutUint16BE(...)	\
+	Macro(emType_PutOrder((uint16), 16, BE, __VA_ARGS__))
+
+#define	emType_PutUint16LE(...)	\
+	Macro(emType_PutOrder((uint16), 16, LE, __VA_ARGS__))
+
+#define	emType_PutInt32BE(...)	\
+	Macro(emType_PutOrder((emType_Bits32), 32, BE, __VA_ARGS__))
+
+#define	emType_PutInt32LE(...)	\
+	Macro(emType_PutOrder((emType_Bits32), 32, LE, __VA_ARGS__))
+
+#define	emType_PutUint32BE(...)	\
+	Macro(emType_PutOrder((emType_Bits32), 32, BE, __VA_ARGS__))
+
+#define	emType_PutUint32LE(...)	\
+	Macro(emType_PutOrder((emType_Bits32), 32, LE, __VA_ARGS__))
+
+#define	emType_PutInt64BE(...)	\
+	Macro(emType_PutOrder((uint64), 64, BE, __VA_ARGS__))
+
+#define	emType_PutInt64LE(...)	\
+	Macro(emType_PutOrder((uint64), 64, LE, __VA_ARGS__))
+
+#define	emType_PutUint64BE(...)	\
+	Macro(emType_PutOrder((uint64), 64, BE, __VA_ARGS__))
+
+#define	emType_PutUint64LE(...)	\
+	Macro(emType_PutOrder((uint64), 64, LE, __VA_ARGS__))
+
+#define	emType_PutFloatBE(...)	\
+	Macro(emType_PutOrder(emType_FloatToBits, 32, BE, __VA_ARGS__))
+
+#define	emType_PutFloatLE(...)	\
+	Macro(emType_PutOrder(emType_FloatToBits, 32, LE, __VA_ARGS__))
+
+#define	emType_PutDoubleBE(...)	\
+	Macro(emType_PutOrder(emType_DoubleToBits, 64, BE, __VA_ARGS__))
+
+#define	emType_PutDoubleLE(...)	\
+	Macro(emType_PutOrder(emType_DoubleToBits, 64, LE, __VA_ARGS__))
 
 #if emType_Shorthand >= 1
-#define	type_DoReverse			emType_DoReverse
+#define	type_GetShortBE			emType_GetShortBE
+#define	type_GetShortLE			emType_GetShortLE
+#define	type_GetUshortBE		emType_GetUshortBE
+#define	type_GetUshortLE		emType_GetUshortLE
+#define	type_GetInt16BE			emType_GetInt16BE
+#define	type_GetInt16LE			emType_GetInt16LE
+#define	type_GetUint16BE		emType_GetUint16BE
+#define	type_GetUint16LE		emType_GetUint16LE
+#define	type_GetInt32BE			emType_GetInt32BE
+#define	type_GetInt32LE			emType_GetInt32LE
+#define	type_GetUint32BE		emType_GetUint32BE
+#define	type_GetUint32LE		emType_GetUint32LE
+#define	type_GetInt64BE			emType_GetInt64BE
+#define	type_GetInt64LE			emType_GetInt64LE
+#define	type_GetUint64BE		emType_GetUint64BE
+#define	type_GetUint64LE		emType_GetUint64LE
+#define	type_GetFloatBE			emType_GetFloatBE
+#define	type_GetFloatLE			emType_GetFloatLE
+#define	type_GetDoubleBE		emType_GetDoubleBE
+#define	type_GetDoubleLE		emType_GetDoubleLE
+#define	type_PutShortBE			emType_PutShortBE
+#define	type_PutShortLE			emType_PutShortLE
+#define	type_PutUshortBE		emType_PutUshortBE
+#define	type_PutUshortLE		emType_PutUshortLE
+#define	type_PutInt16BE			emType_PutInt16BE
+#define	type_PutInt16LE			emType_PutInt16LE
+#define	type_PutUint16BE		emType_PutUint16BE
+#define	type_PutUint16LE		emType_PutUint16LE
+#define	type_PutInt32BE			emType_PutInt32BE
+#define	type_PutInt32LE			emType_PutInt32LE
+#define	type_PutUint32BE		emType_PutUint32BE
+#define	type_PutUint32LE		emType_PutUint32LE
+#define	type_PutInt64BE			emType_PutInt64BE
+#define	type_PutInt64LE			emType_PutInt64LE
+#define	type_PutUint64BE		emType_PutUint64BE
+#define	type_PutUint64LE		emType_PutUint64LE
+#define	type_PutFloatBE			emType_PutFloatBE
+#define	type_PutFloatLE			emType_PutFloatLE
+#define	type_PutDoubleBE		emType_PutDoubleBE
+#define	type_PutDoubleLE		emType_PutDoubleLE
 #endif
 
 #if	emType_Shorthand >= 2
-#define	typDoReverse			emType_DoReverse
+#define	typGetShortBE			emType_GetShortBE
+#define	typGetShortLE			emType_GetShortLE
+#define	typGetUshortBE			emType_GetUshortBE
+#define	typGetUshortLE			emType_GetUshortLE
+#define	typGetInt16BE			emType_GetInt16BE
+#define	typGetInt16LE			emType_GetInt16LE
+#define	typGetUint16BE			emType_GetUint16BE
+#define	typGetUint16LE			emType_GetUint16LE
+#define	typGetInt32BE			emType_GetInt32BE
+#define	typGetInt32LE			emType_GetInt32LE
+#define	typGetUint32BE			emType_GetUint32BE
+#define	typGetUint32LE			emType_GetUint32LE
+#define	typGetInt64BE			emType_GetInt64BE
+#define	typGetInt64LE			emType_GetInt64LE
+#define	typGetUint64BE			emType_GetUint64BE
+#define	typGetUint64LE			emType_GetUint64LE
+#define	typGetFloatBE			emType_GetFloatBE
+#define	typGetFloatLE			emType_GetFloatLE
+#define	typGetDoubleBE			emType_GetDoubleBE
+#define	typGetDoubleLE			emType_GetDoubleLE
+#define	typPutShortBE			emType_PutShortBE
+#define	typPutShortLE			emType_PutShortLE
+#define	typPutUshortBE			emType_PutUshortBE
+#define	typPutUshortLE			emType_PutUshortLE
+#define	typPutInt16BE			emType_PutInt16BE
+#define	typPutInt16LE			emType_PutInt16LE
+#define	typPutUint16BE			emType_PutUint16BE
+#define	typPutUint16LE			emType_PutUint16LE
+#define	typPutInt32BE			emType_PutInt32BE
+#define	typPutInt32LE			emType_PutInt32LE
+#define	typPutUint32BE			emType_PutUint32BE
+#define	typPutUint32LE			emType_PutUint32LE
+#define	typPutInt64BE			emType_PutInt64BE
+#define	typPutInt64LE			emType_PutInt64LE
+#define	typPutUint64BE			emType_PutUint64BE
+#define	typPutUint64LE			emType_PutUint64LE
+#define	typPutFloatBE			emType_PutFloatBE
+#define	typPutFloatLE			emType_PutFloatLE
+#define	typPutDoubleBE			emType_PutDoubleBE
+#define	typPutDoubleLE			emType_PutDoubleLE
 #endif
 
 #if	emType_Shorthand >= 3
-#define	DoReverse				emType_DoReverse
+#define	GetShortBE				emType_GetShortBE
+#define	GetShortLE				emType_GetShortLE
+#define	GetUshortBE				emType_GetUshortBE
+#define	GetUshortLE				emType_GetUshortLE
+#define	GetInt16BE				emType_GetInt16BE
+#define	GetInt16LE				emType_GetInt16LE
+#define	GetUint16BE				emType_GetUint16BE
+#define	GetUint16LE				emType_GetUint16LE
+#define	GetInt32BE				emType_GetInt32BE
+#define	GetInt32LE				emType_GetInt32LE
+#define	GetUint32BE				emType_GetUint32BE
+#define	GetUint32LE				emType_GetUint32LE
+#define	GetInt64BE				emType_GetInt64BE
+#define	GetInt64LE				emType_GetInt64LE
+#define	GetUint64BE				emType_GetUint64BE
+#define	GetUint64LE				emType_GetUint64LE
+#define	GetFloatBE				emType_GetFloatBE
+#define	GetFloatLE				emType_GetFloatLE
+#define	GetDoubleBE				emType_GetDoubleBE
+#define	GetDoubleLE				emType_GetDoubleLE
+#define	PutShortBE				emType_PutShortBE
+#define	PutShortLE				emType_PutShortLE
+#define	PutUshortBE				emType_PutUshortBE
+#define	PutUshortLE				emType_PutUshortLE
+#define	PutInt16BE				emType_PutInt16BE
+#define	PutInt16LE				emType_PutInt16LE
+#define	PutUint16BE				emType_PutUint16BE
+#define	PutUint16LE				emType_PutUint16LE
+#define	PutInt32BE				emType_PutInt32BE
+#define	PutInt32LE				emType_PutInt32LE
+#define	PutUint32BE				emType_PutUint32BE
+#define	PutUint32LE				emType_PutUint32LE
+#define	PutInt64BE				emType_PutInt64BE
+#define	PutInt64LE				emType_PutInt64LE
+#define	PutUint64BE				emType_PutUint64BE
+#define	PutUint64LE				emType_PutUint64LE
+#define	PutFloatBE				emType_PutFloatBE
+#define	PutFloatLE				emType_PutFloatLE
+#define	PutDoubleBE				emType_PutDoubleBE
+#define	PutDoubleLE				emType_PutDoubleLE
 #endif
 
 
 
 // Function:
-// Get<Byte/Uint8/Ushort/Uint16>Sum(*src, off, len)
-// Get<Byte/Uint8/Ushort/Uint16>Sum(off, len)
+// DoSwap(*src, off, count, size)
+// DoSwap(off, count, size)
 // 
-// Finds the sum of all bytes/ushorts at the specified source
-// address (src + off) of the specified length (len). If source
-// base address is not specified, this library's internal buffer
-// is assumed as the source base address. This can be used to
-// calculate checksums.
+// Swaps the byte order of each element (of size bytes) in an array of
+// elements (count) stored at the source address (src + off), converting
+// it between big endian and little endian. Elements of 2, 4 and 8 bytes
+// are swapped 32 / 16 bytes at a time on PC (AVX2 / SSSE3 byte shuffle,
+// picked at run time). If source base address is not specified, this
+// library's internal buffer is assumed as the source base address.
 // 
 // Parameters:
 // src:		the base address of source data
-// off:		offset to the data to be summed (src + off)
-// len:		length of data to be summed
+// off:		offset to the array of elements (src + off)
+// count:	number of elements in the array
+// size:	size of each element in bytes
 // 
 // Returns:
-// <type>_value:  the summed value
+// nothing
 // 
-byte emType_GetByteSumExtFn(byte* src, int off, int len)
+typedef void (*emType_DoSwapFnPtr)(byte* src, uint count, byte size);
+
+static void emType_DoSwapScalar(byte* src, uint count, byte size)
 {
-    byte sum = 0;
-    for(src += off; len>0; len--, src++)
-    { sum += *src; }
-    return sum;
+	uint i;
+	byte byt, *lo, *hi;
+	for(i=0; i<count; i++)
+	{
+		switch(size)
+		{
+			case 2:	emType_StoreBits16(src + i * 2, emType_Swap16(emType_LoadBits16(src + i * 2))); break;
+			case 4:	emType_StoreBits32(src + i * 4, emType_Swap32(emType_LoadBits32(src + i * 4))); break;
+			case 8:	emType_StoreBits64(src + i * 8, emType_Swap64(emType_LoadBits64(src + i * 8))); break;
+			default:
+				for(lo = src + i * size, hi = lo + size - 1; lo < hi; lo++, hi--)
+				{
+					byt = *lo;
+					*lo = *hi;
+					*hi = byt;
+				}
+		}
+	}
 }
 
-#define	emType_GetByteSumExt(src, off, len)	\
-	emType_GetByteSumExtFn((byte*)(src), (int)(off), (int)(len))
-
-#define	emType_GetByteSumInt(off, len)	\
-	emType_GetByteSumExt(&emType, off, len)
-
-#define	emType_GetByteSum(...)	\
-	Macro(Macro3(__VA_ARGS__, emType_GetByteSumExt, emType_GetByteSumInt)(__VA_ARGS__))
+#if defined(emType_Dispatch) || defined(emType_SSSE3)
+emType_TargetSsse3 static void emType_DoSwapSsse3(byte* src, uint count, byte size)
+{
+	uint i = 0;
+	__m128i mask;
+	if(size == 2) mask = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+	else if(size == 4) mask = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+	else if(size == 8) mask = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+	else { emType_DoSwapScalar(src, count, size); return; }
+	for(; i + (16 / size) <= count; i += 16 / size)
+		_mm_storeu_si128((__m128i*)(src + i * size), _mm_shuffle_epi8(_mm_loadu_si128((__m128i*)(src + i * size)), mask));
+	emType_DoSwapScalar(src + i * size, count - i, size);
+}
+#endif
 
-#define	emType_GetUint8Sum	\
-	emType_GetByteSum
+#if defined(emType_Dispatch) || defined(emType_AVX2)
+emType_TargetAvx2 static void emType_DoSwapAvx2(byte* src, uint count, byte size)
+{
+	uint i = 0;
+	__m256i mask;
+	if(size == 2) mask = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+		1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+	else if(size == 4) mask = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+		3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+	else if(size == 8) mask = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+		7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+	else { emType_DoSwapScalar(src, count, size); return; }
+	for(; i + (32 / size) <= count; i += 32 / size)
+		_mm256_storeu_si256((__m256i*)(src + i * size), _mm256_shuffle_epi8(_mm256_loadu_si256((__m256i*)(src + i * size)), mask));
+	// SSE code that follows stalls while the upper halves of ymm registers are dirty
+	_mm256_zeroupper();
+	emType_DoSwapSsse3(src + i * size, count - i, size);
+}
+#endif
 
-ushort emType_GetUshortSumExtFn(ushort* src, int off, int len)
+#if defined(emType_Dispatch)
+static emType_DoSwapFnPtr emType_DoSwapSelect(void)
 {
-    ushort sum = 0;
-	len >>= 1;
-    for(src = (ushort*)(((byte*)src) + off); len>0; len--, src++)
-    { sum += *src; }
-    return sum;
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2")) return emType_DoSwapAvx2;
+	if(__builtin_cpu_supports("ssse3")) return emType_DoSwapSsse3;
+	return emType_DoSwapScalar;
 }
+#elif defined(emType_AVX2)
+#define	emType_DoSwapSelect()	emType_DoSwapAvx2
+#elif defined(emType_SSSE3)
+#define	emType_DoSwapSelect()	emType_DoSwapSsse3
+#else
+#define	emType_DoSwapSelect()	emType_DoSwapScalar
+#endif
 
-#define	emType_GetUshortSumExt(src, off, len)	\
-	emType_GetUshortSumExtFn((ushort*)(src), (int)(off), (int)(len))
+void emType_DoSwapExtFn(byte* src, uint count, byte size)
+{
+	static const emType_DoSwapFnPtr swap = emType_DoSwapSelect();
+	swap(src, count, size);
+}
 
-#define	emType_GetUshortSumInt(off, len)	\
-	emType_GetUshortSumExt(&emType, off, len)
+#define	emType_DoSwapExt(src, off, count, size)	\
+	emType_DoSwapExtFn(((byte*)(src)) + (off), (uint)(count), (byte)(size))
 
-#define	emType_GetUshortSum(...)	\
-	Macro(Macro3(__VA_ARGS__, emType_GetUshortSumExt, emType_GetUshortSumInt)(__VA_ARGS__))
+#define	emType_DoSwapInt(off, count, size)	\
+	emType_DoSwapExt(&emType, off, count, size)
 
-#define	emType_GetUint16Sum		emType_GetUshortSum
+#define	emType_DoSwap(...)	\
+	Macro(Macro4(__VA_ARGS__, emType_DoSwapExt, emType_DoSwapInt)(__VA_ARGS__))
 
 #if emType_Shorthand >= 1
-#define	type_GetByteSum			emType_GetByteSum
-#define	type_GetUint8Sum		emType_GetUint8Sum
-#define	type_GetUshortSum		emType_GetUshortSum
-#define	type_GetUint16Sum		emType_GetUint16Sum
+#define	type_DoSwap				emType_DoSwap
 #endif
 
 #if	emType_Shorthand >= 2
-#define	typGetByteSum			emType_GetByteSum
-#define	typGetUint8Sum			emType_GetUint8Sum
-#define	typGetUshortSum			emType_GetUshortSum
-#define	typGetUint16Sum			emType_GetUint16Sum
+#define	typDoSwap				emType_DoSwap
 #endif
 
 #if	emType_Shorthand >= 3
-#define	GetByteSum				emType_GetByteSum
-#define	GetUint8Sum				emType_GetUint8Sum
-#define	GetUshortSum			emType_GetUshortSum
-#define	GetUint16Sum			emType_GetUint16Sum
+#define	DoSwap					emType_DoSwap
 #endif
 
 
 
 // Function:
-// GetHexFromBin(*dst, sz, *src, off, len, opt)
-// GetHexFromBin(*dst, sz, off, len, opt)
+// Get<type>Array[BE/LE](*dst, *src, off, cnt)
+// Get<type>Array[BE/LE](*dst, off, cnt)
+// Get<type>ArrayStep[BE/LE](*dst, *src, off, cnt, step)
+// Get<type>ArrayStep[BE/LE](*dst, off, cnt, step)
+// Put<type>Array[BE/LE](*dst, off, *src, cnt)
+// Put<type>Array[BE/LE](off, *src, cnt)
+// Put<type>ArrayStep[BE/LE](*dst, off, *src, cnt, step)
+// Put<type>ArrayStep[BE/LE](off, *src, cnt, step)
 // 
-// Get hexadecimal string (dst) of maximum specified size (sz) of
-// the soure binary data (src + off) of specified length (len). The
-// options (opt) specify how the conversion is to be performed, and
-// it takes as input a set of flags. If source base address is not
-// specified, this library's internal buffer is assumed as the source
-// base address.
+// Gets / puts an array of <type> values (cnt) from / to the specified
+// address with offset (src + off or dst + off), which need not be
+// aligned. Optionally, the values are stored in big endian (BE) or
+// little endian (LE) byte order. With the Step form, consecutive values
+// are a number of bytes (step) apart, as in interleaved channel data.
+// Contiguous arrays whose stored size matches <type> are copied as a
+// block (and byte swapped with DoSwap, if needed); others are converted
+// element by element with unaligned loads / stores. If address is not
+// specified, then this library's internal buffer is used.
 // 
 // Parameters:
-// dst:	      the destination string where hex string will be stored
-// sz:        the maximum possible size of the hex string (buffer size)
-// src:	      the base address of source binary data
-// off:	      offset to the binary data to be converted (src + off)
-// len:	      length of data to be converted
-// opt:	      conversion options (TYPE_ADD_SPACE, TYPE_ADD_CHAR, TYPE_BIG_ENDIAN)
+// dst:		the destination array (Get) / base address of destination (Put)
+// src:		the base address of stored data (Get) / the source array (Put)
+// off:		offset of the first <type> value
+// cnt:		number of <type> values
+// step:	distance between consecutive stored values (in bytes)
 // 
 // Returns:
 // nothing
 // 
-#define emType_HEX_TO_BIN(ch)		(((ch) <= '9')? (ch)-'0' : (ch)-'7')
+#define	emType_ArrayFnMake(name, type, bits, get, put)	\
+void emType_Get##name##ArrayFn(void* dst, byte* src, uint cnt, uint step, byte swap)	\
+{	\
+	type* pdst = (type*)dst;	\
+	if(sizeof(type) == (bits) / 8 && step == (bits) / 8)	\
+	{	\
+		memcpy(dst, src, cnt * ((bits) / 8));	\
+		if(swap) emType_DoSwapExtFn((byte*)dst, cnt, (bits) / 8);	\
+		return;	\
+	}	\
+	if(swap) for(; cnt>0; cnt--, src+=step, pdst++)	\
+	{ *pdst = get(emType_Swap##bits(emType_LoadBits##bits(src))); }	\
+	else for(; cnt>0; cnt--, src+=step, pdst++)	\
+	{ *pdst = get(emType_LoadBits##bits(src)); }	\
+}	\
+	\
+void emType_Put##name##ArrayFn(byte* dst, void* src, uint cnt, uint step, byte swap)	\
+{	\
+	type* psrc = (type*)src;	\
+	if(sizeof(type) == (bits) / 8 && step == (bits) / 8)	\
+	{	\
+		memcpy(dst, src, cnt * ((bits) / 8));	\
+		if(swap) emType_DoSwapExtFn(dst, cnt, (bits) / 8);	\
+		return;	\
+	}	\
+	if(swap) for(; cnt>0; cnt--, dst+=step, psrc++)	\
+	{ emType_StoreBits##bits(dst, emType_Swap##bits(put(*psrc))); }	\
+	else for(; cnt>0; cnt--, dst+=step, psrc++)	\
+	{ emType_StoreBits##bits(dst, put(*psrc)); }	\
+}
 
-#define emType_BIN_TO_HEX(bn)		(((bn) <= 9)? (bn)+'0' : (bn)+'7' )
+emType_ArrayFnMake(Short, short, 16, (short), (uint16))
+emType_ArrayFnMake(Ushort, ushort, 16, (ushort), (uint16))
+emType_ArrayFnMake(Int16, int16, 16, (int16), (uint16))
+emType_ArrayFnMake(Uint16, uint16, 16, (uint16), (uint16))
+emType_ArrayFnMake(Int32, int32, 32, (int32)(emType_Sbits32), (emType_Bits32))
+emType_ArrayFnMake(Uint32, uint32, 32, (uint32), (emType_Bits32))
+emType_ArrayFnMake(Int64, int64, 64, (int64), (uint64))
+emType_ArrayFnMake(Uint64, uint64, 64, (uint64), (uint64))
+emType_ArrayFnMake(Float, float, 32, emType_BitsToFloat, emType_FloatToBits)
+emType_ArrayFnMake(Double, double, 64, emType_BitsToDouble, emType_DoubleToBits)
 
-#define	emType_NO_SPACE				0
+#define	emType_GetArrayExt(name, swap, dst, src, off, cnt, step)	\
+	emType_Get##name##ArrayFn((void*)(dst), ((byte*)(src)) + (off), (uint)(cnt), (uint)(step), (byte)(swap))
 
-#define emType_ADD_SPACE			1
+#define	emType_GetArrayInt(name, swap, dst, off, cnt, step)	\
+	emType_GetArrayExt(name, swap, dst, &emType, off, cnt, step)
 
-#define	emType_HAS_SPACE			1
+#define	emType_GetArray(...)	\
+	Macro(Macro7(__VA_ARGS__, emType_GetArrayExt, emType_GetArrayInt)(__VA_ARGS__))
 
-#define	emType_NO_CHAR				0
+#define	emType_PutArrayExt(name, swap, dst, off, src, cnt, step)	\
+	emType_Put##name##ArrayFn(((byte*)(dst)) + (off), (void*)(src), (uint)(cnt), (uint)(step), (byte)(swap))
 
-#define emType_ADD_CHAR				2
+#define	emType_PutArrayInt(name, swap, off, src, cnt, step)	\
+	emType_PutArrayExt(name, swap, &emType, off, src, cnt, step)
 
-#define	emType_HAS_CHAR				2
+#define	emType_PutArray(...)	\
+	Macro(Macro7(__VA_ARGS__, emType_PutArrayExt, emType_PutArrayInt)(__VA_ARGS__))
 
-#define	emType_LITTLE_ENDIAN		0
+#define	emType_GetShortArray(...)	\
+	Macro(emType_GetArray(Short, 0, __VA_ARGS__, 2))
 
-#define emType_BIG_ENDIAN			4
+#define	emType_GetShortArrayBE(...)	\
+	Macro(emType_GetArray(Short, emType_LittleEndian, __VA_ARGS__, 2))
 
-string emType_GetHexFromBinExtFn(string dst, int sz, byte* src, int off, int len, byte opt)
-{
-	string dend = dst + (sz - 1);
-	src += off + ((opt & emType_BIG_ENDIAN)? 0 : (len - 1));
-	int stp = (opt & emType_BIG_ENDIAN)? 1 : -1;
-	for(int i=0; i<len; i++, src+=stp)
-	{
-		*dst = emType_BIN_TO_HEX(*src >> 4); dst++; if(dst >= dend) break;
-		*dst = emType_BIN_TO_HEX(*src & 0xF); dst++; if(dst >= dend) break;
-		if(opt & emType_ADD_CHAR) { *dst = (*src < 32 || *src > 127)? '.' : *src; dst++; if(dst >= dend) break;}
-		if(opt & emType_ADD_SPACE) { *dst = ' '; dst++; if(dst >= dend) break;}
-	}
-	*dst = '\0';
-	return dst;
-}
+#define	emType_GetShortArrayLE(...)	\
+	Macro(emType_GetArray(Short, (1 - emType_LittleEndian), __VA_ARGS__, 2))
 
-#define	emType_GetHexFromBinExt(dst, sz, src, off, len, opt)	\
-	emType_GetHexFromBinExtFn((string)(dst), (int)(sz), (byte*)(src), (int)(off), (int)(len), (byte)(opt))
+#define	emType_GetShortArrayStep(...)	\
+	Macro(emType_GetArray(Short, 0, __VA_ARGS__))
 
-#define	emType_GetHexFromBinInt(dst, sz, off, len, opt)	\
-	emType_GetHexFromBinExt(dst, sz, &emType, off, len, opt)
+#define	emType_GetShortArrayStepBE(...)	\
+	Macro(emType_GetArray(Short, emType_LittleEndian, __VA_ARGS__))
 
-#define	emType_GetHexFromBin(...)	\
-	Macro(Macro6(__VA_ARGS__, emType_GetHexFromBinExt, emType_GetHexFromBinInt)(__VA_ARGS__))
+#define	emType_GetShortArrayStepLE(...)	\
+	Macro(emType_GetArray(Short, (1 - emType_LittleEndian), __VA_ARGS__))
 
-#if emType_Shorthand >= 1
-#define	type_HEX_TO_BIN			emType_HEX_TO_BIN
-#define	type_BIN_TO_HEX			emType_BIN_TO_HEX
-#define	type_NO_SPACE			emType_NO_SPACE
-#define	type_ADD_SPACE			emType_ADD_SPACE
-#define	type_HAS_SPACE			emType_HAS_SPACE
-#define	type_NO_CHAR			emType_NO_CHAR
-#define	type_ADD_CHAR			emType_ADD_CHAR
-#define	type_HAS_CHAR			emType_HAS_CHAR
-#define	type_LITTLE_ENDIAN		emType_LITTLE_ENDIAN
-#define	type_BIG_ENDIAN			emType_BIG_ENDIAN
-#define	type_GetHexFromBin		emType_GetHexFromBin
-#endif
+#define	emType_GetUshortArray(...)	\
+	Macro(emType_GetArray(Ushort, 0, __VA_ARGS__, 2))
 
-#if	emType_Shorthand >= 2
-#define	typHEX_TO_BIN			emType_HEX_TO_BIN
-#define	typBIN_TO_HEX			emType_BIN_TO_HEX
-#define	typNO_SPACE				emType_NO_SPACE
-#define	typADD_SPACE			emType_ADD_SPACE
-#define	typHAS_SPACE			emType_HAS_SPACE
-#define	typNO_CHAR				emType_NO_CHAR
+#define	emType_GetUshortArrayBE(...)	\
+	Macro(emType_GetArray(Ushort, emType_LittleEndian, __VA_ARGS__, 2))
+
+#define	emType_GetUshortArrayLE(...)	\
+	Macro(emType_GetArray(Ushort, (1 - emType_LittleEndian), __VA_ARGS__, 2))
+
+#define	emType_GetUshortArrayStep(...)	\
+	Macro(emType_GetArray(Ushort, 0, __VA_ARGS__))
+
+#define	emType_GetUshortArrayStepBE(...)	\
+	Macro(emType_GetArray(Ushort, emType_LittleEndian, __VA_ARGS__))
+
+#define	emType_GetUshortArrayStepLE(...)	\
+	Macro(emType_GetArray(Ushort, (1 - emType_LittleEndian), __VA_ARGS__))
+
+#define	emType_GetInt16Array(...)	\
+	Macro(emType_GetArray(Int16, 0, __VA_ARGS__, 2))
+
+#define	emType_GetInt16ArrayBE(...)	\
+	Macro(emType_GetArray(Int16, emType_LittleEndian, __VA_ARGS__, 2))
+
+#define	emType_GetInt16ArrayLE(...)	\
+	Macro(emType_GetArray(Int16, (1 - emType_LittleEndian), __VA_ARGS__, 2))
+
+#define	emType_GetInt16ArrayStep(...)	\
+	Macro(emType_GetArray(Int16, 0, __VA_ARGS__))
+
+#define	emType_GetInt16ArrayStepBE(...)	\
+	Macro(emType_GetArray(Int16, emType_LittleEndian, __VA_ARGS__))
+
+#define	emType_GetInt16ArrayStepLE(...)	\
+	Macro(emType_GetArray(Int16, (1 - emType_LittleEndian), __VA_ARGS__))
+
+#define	emType_GetUint16Array(...)	\
+	Macro(emType_GetArray(Uint16, 0, __VA_ARGS__, 2))
+
+#define	emType_GetUint16ArrayBE(...)	\
+	Macro(emType_GetArray(Uint16, emType_LittleEndian, __VA_ARGS__, 2))
+
+#define	emType_GetUint16ArrayLE(...)	\
+	Macro(emType_GetArray(Uint16, (1 - emType_LittleEndian), __VA_ARGS__, 2))
+
+#define	emType_GetUint16ArrayStep(...)	\
+	Macro(emType_GetArray(Uint16, 0, __VA_ARGS__))
+
+#define	emType_GetUint16ArrayStepBE(...)	\
+	Macro(emType_GetArray(Uint16, emType_LittleEndian, __VA_ARGS__))
+
+#define	emType_GetUint16ArrayStepLE(...)	\
+	Macro(emType_GetArray(Uint16, (1 - emType_LittleEndian), __VA_ARGS__))
+
+#define	emType_GetInt32Array(...)	\
+	Macro(emType_GetArray(Int32, 0, __VA_ARGS__, 4))
+
+#define	emType_GetInt32ArrayBE(...)	\
+	Macro(emType_GetArray(Int32, emType_LittleEndian, __VA_ARGS__, 4))
+
+#define	emType_GetInt32ArrayLE(...)	\
+	Macro(emType_GetArray(Int32, (1 - emType_LittleEndian), __VA_ARGS__, 4))
+
+#define	emType_GetInt32ArrayStep(...)	\
+	Macro(emType_GetArray(Int32, 0, __VA_ARGS__))
+
+#define	emType_GetInt32ArrayStepBE(...)	\
+	Macro(emType_GetArray(Int32, emType_LittleEndian, __VA_ARGS__))
+
+#define	emType_GetInt32ArrayStepLE(...)	\
+	Macro(emType_GetArray(Int32, (1 - emType_LittleEndian), __VA_ARGS__))
+
+#define	emType_GetUint32Array(...)	\
+	Macro(emType_GetArray(Uint32, 0, __VA_ARGS__, 4))
+
+#define	emType_GetUint32ArrayBE(...)	\
+	Macro(emType_GetArray(Uint32, emType_LittleEndian, __VA_ARGS__, 4))
+
+#define	emType_GetUint32ArrayLE(...)	\
+	Macro(emType_GetArray(Uint32, (1 - emType_LittleEndian), __VA_ARGS__, 4))
+
+#define	emType_GetUint32ArrayStep(...)	\
+	Macro(emType_GetArray(Uint32, 0, __VA_ARGS__))
+
+#define	emType_GetUint32ArrayStepBE(...)	\
+	Macro(emType_GetArray(Uint32, emType_LittleEndian, __VA_ARGS__))
+
+#define	emType_GetUint32ArrayStepLE(...)	\
+	Macro(emType_GetArray(Uint32, (1 - emType_LittleEndian), __VA_ARGS__))
+
+#define	emType_GetInt64Array(...)	\
+	Macro(emType_GetArray(Int64, 0, __VA_ARGS__, 8))
+
+#define	emType_GetInt64ArrayBE(...)	\
+	Macro(emType_GetArray(Int64, emType_LittleEndian, __VA_ARGS__, 8))
+
+#define	emType_GetInt64ArrayLE(...)	\
+	Macro(emType_GetArray(Int64, (1 - emType_LittleEndian), __VA_ARGS__, 8))
+
+#define	emType_GetInt64ArrayStep(...)	\
+	Macro(emType_GetArray(Int64, 0, __VA_ARGS__))
+
+#define	emType_GetInt64ArrayStepBE(...)	\
+	Macro(emType_GetArray(Int64, emType_LittleEndian, __VA_ARGS__))
+
+#define	emType_GetInt64ArrayStepLE(...)	\
+	Macro(emType_GetArray(Int64, (1 - emType_LittleEndian), __VA_ARGS__))
+
+#define	emType_GetUint64Array(...)	\
+	Macro(emType_GetArray(Uint64, 0, __VA_ARGS__, 8))
+
+#define	emType_GetUint64ArrayBE(...)	\
+	Macro(emType_GetArray(Uint64, emType_LittleEndian, __VA_ARGS__, 8))
+
+#define	emType_GetUint64ArrayLE(...)	\
+	Macro(emType_GetArray(Uint64, (1 - emType_LittleEndian), __VA_ARGS__, 8))
+
+#define	emType_GetUint64ArrayStep(...)	\
+	Macro(emType_GetArray(Uint64, 0, __VA_ARGS__))
+
+#define	emType_GetUint64ArrayStepBE(...)	\
+	Macro(emType_GetArray(Uint64, emType_LittleEndian, __VA_ARGS__))
+
+#define	emType_GetUint64ArrayStepLE(...)	\
+	Macro(emType_GetArray(Uint64, (1 - emType_LittleEndian), __VA_ARGS__))
+
+#define	emType_GetFloatArray(...)	\
+	Macro(emType_GetArray(Float, 0, __VA_ARGS__, 4))
+
+#define	emType_GetFloatArrayBE(...)	\
+	Macro(emType_GetArray(Float, emType_LittleEndian, __VA_ARGS__, 4))
+
+#define	emType_GetFloatArrayLE(...)	\
+	Macro(emType_GetArray(Float, (1 - emType_LittleEndian), __VA_ARGS__, 4))
+
+#define	emType_GetFloatArrayStep(...)	\
+	Macro(emType_GetArray(Float, 0, __VA_ARGS__))
+
+#define	emType_GetFloatArrayStepBE(...)	\
+	Macro(emType_GetArray(Float, emType_LittleEndian, __VA_ARGS__))
+
+#define	emType_GetFloatArrayStepLE(...)	\
+	Macro(emType_GetArray(Float, (1 - emType_LittleEndian), __VA_ARGS__))
+
+#define	emType_GetDoubleArray(...)	\
+	Macro(emType_GetArray(Double, 0, __VA_ARGS__, 8))
+
+#define	emType_GetDoubleArrayBE(...)	\
+	Macro(emType_GetArray(Double, emType_LittleEndian, __VA_ARGS__, 8))
+
+#define	emType_GetDoubleArrayLE(...)	\
+	Macro(emType_GetArray(Double, (1 - emType_LittleEndian), __VA_ARGS__, 8))
+
+#define	emType_GetDoubleArrayStep(...)	\
+	Macro(emType_GetArray(Double, 0, __VA_ARGS__))
+
+#define	emType_GetDoubleArrayStepBE(...)	\
+	Macro(emType_GetArray(Double, emType_LittleEndian, __VA_ARGS__))
+
+#define	emType_GetDoubleArrayStepLE(...)	\
+	Macro(emType_GetArray(Double, (1 - emType_LittleEndian), __VA_ARGS__))
+
+#define	emType_PutShortArray(...)	\
+	Macro(emType_PutArray(Short, 0, __VA_ARGS__, 2))
+
+#define	emType_PutShortArrayBE(...)	\
+	Macro(emType_PutArray(Short, emType_LittleEndian, __VA_ARGS__, 2))
+
+#define	emType_PutShortArrayLE(...)	\
+	Macro(emType_PutArray(Short, (1 - emType_LittleEndian), __VA_ARGS__, 2))
+
+#define	emType_PutShortArrayStep(...)	\
+	Macro(emType_PutArray(Short, 0, __VA_ARGS__))
+
+#define	emType_PutShortArrayStepBE(...)	\
+	Macro(emType_PutArray(Short, emType_LittleEndian, __VA_ARGS__))
+
+#define	emType_PutShortArrayStepLE(...)	\
+	Macro(emType_PutArray(Short, (1 - emType_LittleEndian), __VA_ARGS__))
+
+#define	emType_PutUshortArray(...)	\
+	Macro(emType_PutArray(Ushort, 0, __VA_ARGS__, 2))
+
+#define	emType_PutUshortArrayBE(...)	\
+	Macro(emType_PutArray(Ushort, emType_LittleEndian, __VA_ARGS__, 2))
+
+#define	emType_PutUshortArrayLE(...)	\
+	Macro(emType_PutArray(Ushort, (1 - emType_LittleEndian), __VA_ARGS__, 2))
+
+#define	emType_PutUshortArrayStep(...)	\
+	Macro(emType_PutArray(Ushort, 0, __VA_ARGS__))
+
+#define	emType_PutUshortArrayStepBE(...)	\
+	Macro(emType_PutArray(Ushort, emType_LittleEndian, __VA_ARGS__))
+
+#define	emType_PutUshortArrayStepLE(...)	\
+	Macro(emType_PutArray(Ushort, (1 - emType_LittleEndian), __VA_ARGS__))
+
+#define	emType_PutInt16Array(...)	\
+	Macro(emType_PutArray(Int16, 0, __VA_ARGS__, 2))
+
+#define	emType_PutInt16ArrayBE(...)	\
+	Macro(emType_PutArray(Int16, emType_LittleEndian, __VA_ARGS__, 2))
+
+#define	emType_PutInt16ArrayLE(...)	\
+	Macro(emType_PutArray(Int16, (1 - emType_LittleEndian), __VA_ARGS__, 2))
+
+#define	emType_PutInt16ArrayStep(...)	\
+	Macro(emType_PutArray(Int16, 0, __VA_ARGS__))
+
+#define	emType_PutInt16ArrayStepBE(...)	\
+	Macro(emType_PutArray(Int16, emType_LittleEndian, __VA_ARGS__))
+
+#define	emType_PutInt16ArrayStepLE(...)	\
+	Macro(emType_PutArray(Int16, (1 - emType_LittleEndian), __VA_ARGS__))
+
+#define	emType_PutUint16Array(...)	\
+	Macro(emType_PutArray(Uint16, 0, __VA_ARGS__, 2))
+
+#define	emType_PutUint16ArrayBE(...)	\
+	Macro(emType_PutArray(Uint16, emType_LittleEndian, __VA_ARGS__, 2))
+
+#define	emType_PutUint16ArrayLE(...)	\
+	Macro(emType_PutArray(Uint16, (1 - emType_LittleEndian), __VA_ARGS__, 2))
+
+#define	emType_PutUint16ArrayStep(...)	\
+	Macro(emType_PutArray(Uint16, 0, __VA_ARGS__))
+
+#define	emType_PutUint16ArrayStepBE(...)	\
+	Macro(emType_PutArray(Uint16, emType_LittleEndian, __VA_ARGS__))
+
+#define	emType_PutUint16ArrayStepLE(...)	\
+	Macro(emType_PutArray(Uint16, (1 - emType_LittleEndian), __VA_ARGS__))
+
+#define	emType_PutInt32Array(...)	\
+	Macro(emType_PutArray(Int32, 0, __VA_ARGS__, 4))
+
+#define	emType_PutInt32ArrayBE(...)	\
+	Macro(emType_PutArray(Int32, emType_LittleEndian, __VA_ARGS__, 4))
+
+#define	emType_PutInt32ArrayLE(...)	\
+	Macro(emType_PutArray(Int32, (1 - emType_LittleEndian), __VA_ARGS__, 4))
+
+#define	emType_PutInt32ArrayStep(...)	\
+	Macro(emType_PutArray(Int32, 0, __VA_ARGS__))
+
+#define	emType_PutInt32ArrayStepBE(...)	\
+	Macro(emType_PutArray(Int32, emType_LittleEndian, __VA_ARGS__))
+
+#define	emType_PutInt32ArrayStepLE(...)	\
+	Macro(emType_PutArray(Int32, (1 - emType_LittleEndian), __VA_ARGS__))
+
+#define	emType_PutUint32Array(...)	\
+	Macro(emType_PutArray(Uint32, 0, __VA_ARGS__, 4))
+
+#define	emType_PutUint32ArrayBE(...)	\
+	Macro(emType_PutArray(Uint32, emType_LittleEndian, __VA_ARGS__, 4))
+
+#define	emType_PutUint32ArrayLE(...)	\
+	Macro(emType_PutArray(Uint32, (1 - emType_LittleEndian), __VA_ARGS__, 4))
+
+#define	emType_PutUint32ArrayStep(...)	\
+	Macro(emType_PutArray(Uint32, 0, __VA_ARGS__))
+
+#define	emType_PutUint32ArrayStepBE(...)	\
+	Macro(emType_PutArray(Uint32, emType_LittleEndian, __VA_ARGS__))
+
+#define	emType_PutUint32ArrayStepLE(...)	\
+	Macro(emType_PutArray(Uint32, (1 - emType_LittleEndian), __VA_ARGS__))
+
+#define	emType_PutInt64Array(...)	\
+	Macro(emType_PutArray(Int64, 0, __VA_ARGS__, 8))
+
+#define	emType_PutInt64ArrayBE(...)	\
+	Macro(emType_PutArray(Int64, emType_LittleEndian, __VA_ARGS__, 8))
+
+#define	emType_PutInt64ArrayLE(...)	\
+	Macro(emType_PutArray(Int64, (1 - emType_LittleEndian), __VA_ARGS__, 8))
+
+#define	emType_PutInt64ArrayStep(...)	\
+	Macro(emType_PutArray(Int64, 0, __VA_ARGS__))
+
+#define	emType_PutInt64ArrayStepBE(...)	\
+	Macro(emType_PutArray(Int64, emType_LittleEndian, __VA_ARGS__))
+
+#define	emType_PutInt64ArrayStepLE(...)	\
+	Macro(emType_PutArray(Int64, (1 - emType_LittleEndian), __VA_ARGS__))
+
+#define	emType_PutUint64Array(...)	\
+	Macro(emType_PutArray(Uint64, 0, __VA_ARGS__, 8))
+
+#define	emType_PutUint64ArrayBE(...)	\
+	Macro(emType_PutArray(Uint64, emType_LittleEndian, __VA_ARGS__, 8))
+
+#define	emType_PutUint64ArrayLE(...)	\
+	Macro(emType_PutArray(Uint64, (1 - emType_LittleEndian), __VA_ARGS__, 8))
+
+#define	emType_PutUint64ArrayStep(...)	\
+	Macro(emType_PutArray(Uint64, 0, __VA_ARGS__))
+
+#define	emType_PutUint64ArrayStepBE(...)	\
+	Macro(emType_PutArray(Uint64, emType_LittleEndian, __VA_ARGS__))
+
+#define	emType_PutUint64ArrayStepLE(...)	\
+	Macro(emType_PutArray(Uint64, (1 - emType_LittleEndian), __VA_ARGS__))
+
+#define	emType_PutFloatArray(...)	\
+	Macro(emType_PutArray(Float, 0, __VA_ARGS__, 4))
+
+#define	emType_PutFloatArrayBE(...)	\
+	Macro(emType_PutArray(Float, emType_LittleEndian, __VA_ARGS__, 4))
+
+#define	emType_PutFloatArrayLE(...)	\
+	Macro(emType_PutArray(Float, (1 - emType_LittleEndian), __VA_ARGS__, 4))
+
+#define	emType_PutFloatArrayStep(...)	\
+	Macro(emType_PutArray(Float, 0, __VA_ARGS__))
+
+#define	emType_PutFloatArrayStepBE(...)	\
+	Macro(emType_PutArray(Float, emType_LittleEndian, __VA_ARGS__))
+
+#define	emType_PutFloatArrayStepLE(...)	\
+	Macro(emType_PutArray(Float, (1 - emType_LittleEndian), __VA_ARGS__))
+
+#define	emType_PutDoubleArray(...)	\
+	Macro(emType_PutArray(Double, 0, __VA_ARGS__, 8))
+
+#define	emType_PutDoubleArrayBE(...)	\
+	Macro(emType_PutArray(Double, emType_LittleEndian, __VA_ARGS__, 8))
+
+#define	emType_PutDoubleArrayLE(...)	\
+	Macro(emType_PutArray(Double, (1 - emType_LittleEndian), __VA_ARGS__, 8))
+
+#define	emType_PutDoubleArrayStep(...)	\
+	Macro(emType_PutArray(Double, 0, __VA_ARGS__))
+
+#define	emType_PutDoubleArrayStepBE(...)	\
+	Macro(emType_PutArray(Double, emType_LittleEndian, __VA_ARGS__))
+
+#define	emType_PutDoubleArrayStepLE(...)	\
+	Macro(emType_PutArray(Double, (1 - emType_LittleEndian), __VA_ARGS__))
+
+#if emType_Shorthand >= 1
+#define	type_GetShortArray		emType_GetShortArray
+#define	type_GetShortArrayBE	emType_GetShortArrayBE
+#define	type_GetShortArrayLE	emType_GetShortArrayLE
+#define	type_GetShortArrayStep	emType_GetShortArrayStep
+#define	type_GetShortArrayStepBE	emType_GetShortArrayStepBE
+#define	type_GetShortArrayStepLE	emType_GetShortArrayStepLE
+#define	type_GetUshortArray		emType_GetUshortArray
+#define	type_GetUshortArrayBE	emType_GetUshortArrayBE
+#define	type_GetUshortArrayLE	emType_GetUshortArrayLE
+#define	type_GetUshortArrayStep	emType_GetUshortArrayStep
+#define	type_GetUshortArrayStepBE	emType_GetUshortArrayStepBE
+#define	type_GetUshortArrayStepLE	emType_GetUshortArrayStepLE
+#define	type_GetInt16Array		emType_GetInt16Array
+#define	type_GetInt16ArrayBE	emType_GetInt16ArrayBE
+#define	type_GetInt16ArrayLE	emType_GetInt16ArrayLE
+#define	type_GetInt16ArrayStep	emType_GetInt16ArrayStep
+#define	type_GetInt16ArrayStepBE	emType_GetInt16ArrayStepBE
+#define	type_GetInt16ArrayStepLE	emType_GetInt16ArrayStepLE
+#define	type_GetUint16Array		emType_GetUint16Array
+#define	type_GetUint16ArrayBE	emType_GetUint16ArrayBE
+#define	type_GetUint16ArrayLE	emType_GetUint16ArrayLE
+#define	type_GetUint16ArrayStep	emType_GetUint16ArrayStep
+#define	type_GetUint16ArrayStepBE	emType_GetUint16ArrayStepBE
+#define	type_GetUint16ArrayStepLE	emType_GetUint16ArrayStepLE
+#define	type_GetInt32Array		emType_GetInt32Array
+#define	type_GetInt32ArrayBE	emType_GetInt32ArrayBE
+#define	type_GetInt32ArrayLE	emType_GetInt32ArrayLE
+#define	type_GetInt32ArrayStep	emType_GetInt32ArrayStep
+#define	type_GetInt32ArrayStepBE	emType_GetInt32ArrayStepBE
+#define	type_GetInt32ArrayStepLE	emType_GetInt32ArrayStepLE
+#define	type_GetUint32Array		emType_GetUint32Array
+#define	type_GetUint32ArrayBE	emType_GetUint32ArrayBE
+#define	type_GetUint32ArrayLE	emType_GetUint32ArrayLE
+#define	type_GetUint32ArrayStep	emType_GetUint32ArrayStep
+#define	type_GetUint32ArrayStepBE	emType_GetUint32ArrayStepBE
+#define	type_GetUint32ArrayStepLE	emType_GetUint32ArrayStepLE
+#define	type_GetInt64Array		emType_GetInt64Array
+#define	type_GetInt64ArrayBE	emType_GetInt64ArrayBE
+#define	type_GetInt64ArrayLE	emType_GetInt64ArrayLE
+#define	type_GetInt64ArrayStep	emType_GetInt64ArrayStep
+#define	type_GetInt64ArrayStepBE	emType_GetInt64ArrayStepBE
+#define	type_GetInt64ArrayStepLE	emType_GetInt64ArrayStepLE
+#define	type_GetUint64Array		emType_GetUint64Array
+#define	type_GetUint64ArrayBE	emType_GetUint64ArrayBE
+#define	type_GetUint64ArrayLE	emType_GetUint64ArrayLE
+#define	type_GetUint64ArrayStep	emType_GetUint64ArrayStep
+#define	type_GetUint64ArrayStepBE	emType_GetUint64ArrayStepBE
+#define	type_GetUint64ArrayStepLE	emType_GetUint64ArrayStepLE
+#define	type_GetFloatArray		emType_GetFloatArray
+#define	type_GetFloatArrayBE	emType_GetFloatArrayBE
+#define	type_GetFloatArrayLE	emType_GetFloatArrayLE
+#define	type_GetFloatArrayStep	emType_GetFloatArrayStep
+#define	type_GetFloatArrayStepBE	emType_GetFloatArrayStepBE
+#define	type_GetFloatArrayStepLE	emType_GetFloatArrayStepLE
+#define	type_GetDoubleArray		emType_GetDoubleArray
+#define	type_GetDoubleArrayBE	emType_GetDoubleArrayBE
+#define	type_GetDoubleArrayLE	emType_GetDoubleArrayLE
+#define	type_GetDoubleArrayStep	emType_GetDoubleArrayStep
+#define	type_GetDoubleArrayStepBE	emType_GetDoubleArrayStepBE
+#define	type_GetDoubleArrayStepLE	emType_GetDoubleArrayStepLE
+#define	type_PutShortArray		emType_PutShortArray
+#define	type_PutShortArrayBE	emType_PutShortArrayBE
+#define	type_PutShortArrayLE	emType_PutShortArrayLE
+#define	type_PutShortArrayStep	emType_PutShortArrayStep
+#define	type_PutShortArrayStepBE	emType_PutShortArrayStepBE
+#define	type_PutShortArrayStepLE	emType_PutShortArrayStepLE
+#define	type_PutUshortArray		emType_PutUshortArray
+#define	type_PutUshortArrayBE	emType_PutUshortArrayBE
+#define	type_PutUshortArrayLE	emType_PutUshortArrayLE
+#define	type_PutUshortArrayStep	emType_PutUshortArrayStep
+#define	type_PutUshortArrayStepBE	emType_PutUshortArrayStepBE
+#define	type_PutUshortArrayStepLE	emType_PutUshortArrayStepLE
+#define	type_PutInt16Array		emType_PutInt16Array
+#define	type_PutInt16ArrayBE	emType_PutInt16ArrayBE
+#define	type_PutInt16ArrayLE	emType_PutInt16ArrayLE
+#define	type_PutInt16ArrayStep	emType_PutInt16ArrayStep
+#define	type_PutInt16ArrayStepBE	emType_PutInt16ArrayStepBE
+#define	type_PutInt16ArrayStepLE	emType_PutInt16ArrayStepLE
+#define	type_PutUint16Array		emType_PutUint16Array
+#define	type_PutUint16ArrayBE	emType_PutUint16ArrayBE
+#define	type_PutUint16ArrayLE	emType_PutUint16ArrayLE
+#define	type_PutUint16ArrayStep	emType_PutUint16ArrayStep
+#define	type_PutUint16ArrayStepBE	emType_PutUint16ArrayStepBE
+#define	type_PutUint16ArrayStepLE	emType_PutUint16ArrayStepLE
+#define	type_PutInt32Array		emType_PutInt32Array
+#define	type_PutInt32ArrayBE	emType_PutInt32ArrayBE
+#define	type_PutInt32ArrayLE	emType_PutInt32ArrayLE
+#define	type_PutInt32ArrayStep	emType_PutInt32ArrayStep
+#define	type_PutInt32ArrayStepBE	emType_PutInt32ArrayStepBE
+#define	type_PutInt32ArrayStepLE	emType_PutInt32ArrayStepLE
+#define	type_PutUint32Array		emType_PutUint32Array
+#define	type_PutUint32ArrayBE	emType_PutUint32ArrayBE
+#define	type_PutUint32ArrayLE	emType_PutUint32ArrayLE
+#define	type_PutUint32ArrayStep	emType_PutUint32ArrayStep
+#define	type_PutUint32ArrayStepBE	emType_PutUint32ArrayStepBE
+#define	type_PutUint32ArrayStepLE	emType_PutUint32ArrayStepLE
+#define	type_PutInt64Array		emType_PutInt64Array
+#define	type_PutInt64ArrayBE	emType_PutInt64ArrayBE
+#define	type_PutInt64ArrayLE	emType_PutInt64ArrayLE
+#define	type_PutInt64ArrayStep	emType_PutInt64ArrayStep
+#define	type_PutInt64ArrayStepBE	emType_PutInt64ArrayStepBE
+#define	type_PutInt64ArrayStepLE	emType_PutInt64ArrayStepLE
+#define	type_PutUint64Array		emType_PutUint64Array
+#define	type_PutUint64ArrayBE	emType_PutUint64ArrayBE
+#define	type_PutUint64ArrayLE	emType_PutUint64ArrayLE
+#define	type_PutUint64ArrayStep	emType_PutUint64ArrayStep
+#define	type_PutUint64ArrayStepBE	emType_PutUint64ArrayStepBE
+#define	type_PutUint64ArrayStepLE	emType_PutUint64ArrayStepLE
+#define	type_PutFloatArray		emType_PutFloatArray
+#define	type_PutFloatArrayBE	emType_PutFloatArrayBE
+#define	type_PutFloatArrayLE	emType_PutFloatArrayLE
+#define	type_PutFloatArrayStep	emType_PutFloatArrayStep
+#define	type_PutFloatArrayStepBE	emType_PutFloatArrayStepBE
+#define	type_PutFloatArrayStepLE	emType_PutFloatArrayStepLE
+#define	type_PutDoubleArray		emType_PutDoubleArray
+#define	type_PutDoubleArrayBE	emType_PutDoubleArrayBE
+#define	type_PutDoubleArrayLE	emType_PutDoubleArrayLE
+#define	type_PutDoubleArrayStep	emType_PutDoubleArrayStep
+#define	type_PutDoubleArrayStepBE	emType_PutDoubleArrayStepBE
+#define	type_PutDoubleArrayStepLE	emType_PutDoubleArrayStepLE
+#endif
+
+#if	emType_Shorthand >= 2
+#define	typGetShortArray		emType_GetShortArray
+#define	typGetShortArrayBE		emType_GetShortArrayBE
+#define	typGetShortArrayLE		emType_GetShortArrayLE
+#define	typGetShortArrayStep	emType_GetShortArrayStep
+#define	typGetShortArrayStepBE	emType_GetShortArrayStepBE
+#define	typGetShortArrayStepLE	emType_GetShortArrayStepLE
+#define	typGetUshortArray		emType_GetUshortArray
+#define	typGetUshortArrayBE		emType_GetUshortArrayBE
+#define	typGetUshortArrayLE		emType_GetUshortArrayLE
+#define	typGetUshortArrayStep	emType_GetUshortArrayStep
+#define	typGetUshortArrayStepBE	emType_GetUshortArrayStepBE
+#define	typGetUshortArrayStepLE	emType_GetUshortArrayStepLE
+#define	typGetInt16Array		emType_GetInt16Array
+#define	typGetInt16ArrayBE		emType_GetInt16ArrayBE
+#define	typGetInt16ArrayLE		emType_GetInt16ArrayLE
+#define	typGetInt16ArrayStep	emType_GetInt16ArrayStep
+#define	typGetInt16ArrayStepBE	emType_GetInt16ArrayStepBE
+#define	typGetInt16ArrayStepLE	emType_GetInt16ArrayStepLE
+#define	typGetUint16Array		emType_GetUint16Array
+#define	typGetUint16ArrayBE		emType_GetUint16ArrayBE
+#define	typGetUint16ArrayLE		emType_GetUint16ArrayLE
+#define	typGetUint16ArrayStep	emType_GetUint16ArrayStep
+#define	typGetUint16ArrayStepBE	emType_GetUint16ArrayStepBE
+#define	typGetUint16ArrayStepLE	emType_GetUint16ArrayStepLE
+#define	typGetInt32Array		emType_GetInt32Array
+#define	typGetInt32ArrayBE		emType_GetInt32ArrayBE
+#define	typGetInt32ArrayLE		emType_GetInt32ArrayLE
+#define	typGetInt32ArrayStep	emType_GetInt32ArrayStep
+#define	typGetInt32ArrayStepBE	emType_GetInt32ArrayStepBE
+#define	typGetInt32ArrayStepLE	emType_GetInt32ArrayStepLE
+#define	typGetUint32Array		emType_GetUint32Array
+#define	typGetUint32ArrayBE		emType_GetUint32ArrayBE
+#define	typGetUint32ArrayLE		emType_GetUint32ArrayLE
+#define	typGetUint32ArrayStep	emType_GetUint32ArrayStep
+#define	typGetUint32ArrayStepBE	emType_GetUint32ArrayStepBE
+#define	typGetUint32ArrayStepLE	emType_GetUint32ArrayStepLE
+#define	typGetInt64Array		emType_GetInt64Array
+#define	typGetInt64ArrayBE		emType_GetInt64ArrayBE
+#define	typGetInt64ArrayLE		emType_GetInt64ArrayLE
+#define	typGetInt64ArrayStep	emType_GetInt64ArrayStep
+#define	typGetInt64ArrayStepBE	emType_GetInt64ArrayStepBE
+#define	typGetInt64ArrayStepLE	emType_GetInt64ArrayStepLE
+#define	typGetUint64Array		emType_GetUint64Array
+#define	typGetUint64ArrayBE		emType_GetUint64ArrayBE
+#define	typGetUint64ArrayLE		emType_GetUint64ArrayLE
+#define	typGetUint64ArrayStep	emType_GetUint64ArrayStep
+#define	typGetUint64ArrayStepBE	emType_GetUint64ArrayStepBE
+#define	typGetUint64ArrayStepLE	emType_GetUint64ArrayStepLE
+#define	typGetFloatArray		emType_GetFloatArray
+#define	typGetFloatArrayBE		emType_GetFloatArrayBE
+#define	typGetFloatArrayLE		emType_GetFloatArrayLE
+#define	typGetFloatArrayStep	emType_GetFloatArrayStep
+#define	typGetFloatArrayStepBE	emType_GetFloatArrayStepBE
+#define	typGetFloatArrayStepLE	emType_GetFloatArrayStepLE
+#define	typGetDoubleArray		emType_GetDoubleArray
+#define	typGetDoubleArrayBE		emType_GetDoubleArrayBE
+#define	typGetDoubleArrayLE		emType_GetDoubleArrayLE
+#define	typGetDoubleArrayStep	emType_GetDoubleArrayStep
+#define	typGetDoubleArrayStepBE	emType_GetDoubleArrayStepBE
+#define	typGetDoubleArrayStepLE	emType_GetDoubleArrayStepLE
+#define	typPutShortArray		emType_PutShortArray
+#define	typPutShortArrayBE		emType_PutShortArrayBE
+#define	typPutShortArrayLE		emType_PutShortArrayLE
+#define	typPutShortArrayStep	emType_PutShortArrayStep
+#define	typPutShortArrayStepBE	emType_PutShortArrayStepBE
+#define	typPutShortArrayStepLE	emType_PutShortArrayStepLE
+#define	typPutUshortArray		emType_PutUshortArray
+#define	typPutUshortArrayBE		emType_PutUshortArrayBE
+#define	typPutUshortArrayLE		emType_PutUshortArrayLE
+#define	typPutUshortArrayStep	emType_PutUshortArrayStep
+#define	typPutUshortArrayStepBE	emType_PutUshortArrayStepBE
+#define	typPutUshortArrayStepLE	emType_PutUshortArrayStepLE
+#define	typPutInt16Array		emType_PutInt16Array
+#define	typPutInt16ArrayBE		emType_PutInt16ArrayBE
+#define	typPutInt16ArrayLE		emType_PutInt16ArrayLE
+#define	typPutInt16ArrayStep	emType_PutInt16ArrayStep
+#define	typPutInt16ArrayStepBE	emType_PutInt16ArrayStepBE
+#define	typPutInt16ArrayStepLE	emType_PutInt16ArrayStepLE
+#define	typPutUint16Array		emType_PutUint16Array
+#define	typPutUint16ArrayBE		emType_PutUint16ArrayBE
+#define	typPutUint16ArrayLE		emType_PutUint16ArrayLE
+#define	typPutUint16ArrayStep	emType_PutUint16ArrayStep
+#define	typPutUint16ArrayStepBE	emType_PutUint16ArrayStepBE
+#define	typPutUint16ArrayStepLE	emType_PutUint16ArrayStepLE
+#define	typPutInt32Array		emType_PutInt32Array
+#define	typPutInt32ArrayBE		emType_PutInt32ArrayBE
+#define	typPutInt32ArrayLE		emType_PutInt32ArrayLE
+#define	typPutInt32ArrayStep	emType_PutInt32ArrayStep
+#define	typPutInt32ArrayStepBE	emType_PutInt32ArrayStepBE
+#define	typPutInt32ArrayStepLE	emType_PutInt32ArrayStepLE
+#define	typPutUint32Array		emType_PutUint32Array
+#define	typPutUint32ArrayBE		emType_PutUint32ArrayBE
+#define	typPutUint32ArrayLE		emType_PutUint32ArrayLE
+#define	typPutUint32ArrayStep	emType_PutUint32ArrayStep
+#define	typPutUint32ArrayStepBE	emType_PutUint32ArrayStepBE
+#define	typPutUint32ArrayStepLE	emType_PutUint32ArrayStepLE
+#define	typPutInt64Array		emType_PutInt64Array
+#define	typPutInt64ArrayBE		emType_PutInt64ArrayBE
+#define	typPutInt64ArrayLE		emType_PutInt64ArrayLE
+#define	typPutInt64ArrayStep	emType_PutInt64ArrayStep
+#define	typPutInt64ArrayStepBE	emType_PutInt64ArrayStepBE
+#define	typPutInt64ArrayStepLE	emType_PutInt64ArrayStepLE
+#define	typPutUint64Array		emType_PutUint64Array
+#define	typPutUint64ArrayBE		emType_PutUint64ArrayBE
+#define	typPutUint64ArrayLE		emType_PutUint64ArrayLE
+#define	typPutUint64ArrayStep	emType_PutUint64ArrayStep
+#define	typPutUint64ArrayStepBE	emType_PutUint64ArrayStepBE
+#define	typPutUint64ArrayStepLE	emType_PutUint64ArrayStepLE
+#define	typPutFloatArray		emType_PutFloatArray
+#define	typPutFloatArrayBE		emType_PutFloatArrayBE
+#define	typPutFloatArrayLE		emType_PutFloatArrayLE
+#define	typPutFloatArrayStep	emType_PutFloatArrayStep
+#define	typPutFloatArrayStepBE	emType_PutFloatArrayStepBE
+#define	typPutFloatArrayStepLE	emType_PutFloatArrayStepLE
+#define	typPutDoubleArray		emType_PutDoubleArray
+#define	typPutDoubleArrayBE		emType_PutDoubleArrayBE
+#define	typPutDoubleArrayLE		emType_PutDoubleArrayLE
+#define	typPutDoubleArrayStep	emType_PutDoubleArrayStep
+#define	typPutDoubleArrayStepBE	emType_PutDoubleArrayStepBE
+#define	typPutDoubleArrayStepLE	emType_PutDoubleArrayStepLE
+#endif
+
+#if	emType_Shorthand >= 3
+#define	GetShortArray			emType_GetShortArray
+#define	GetShortArrayBE			emType_GetShortArrayBE
+#define	GetShortArrayLE			emType_GetShortArrayLE
+#define	GetShortArrayStep		emType_GetShortArrayStep
+#define	GetShortArrayStepBE		emType_GetShortArrayStepBE
+#define	GetShortArrayStepLE		emType_GetShortArrayStepLE
+#define	GetUshortArray			emType_GetUshortArray
+#define	GetUshortArrayBE		emType_GetUshortArrayBE
+#define	GetUshortArrayLE		emType_GetUshortArrayLE
+#define	GetUshortArrayStep		emType_GetUshortArrayStep
+#define	GetUshortArrayStepBE	emType_GetUshortArrayStepBE
+#define	GetUshortArrayStepLE	emType_GetUshortArrayStepLE
+#define	GetInt16Array			emType_GetInt16Array
+#define	GetInt16ArrayBE			emType_GetInt16ArrayBE
+#define	GetInt16ArrayLE			emType_GetInt16ArrayLE
+#define	GetInt16ArrayStep		emType_GetInt16ArrayStep
+#define	GetInt16ArrayStepBE		emType_GetInt16ArrayStepBE
+#define	GetInt16ArrayStepLE		emType_GetInt16ArrayStepLE
+#define	GetUint16Array			emType_GetUint16Array
+#define	GetUint16ArrayBE		emType_GetUint16ArrayBE
+#define	GetUint16ArrayLE		emType_GetUint16ArrayLE
+#define	GetUint16ArrayStep		emType_GetUint16ArrayStep
+#define	GetUint16ArrayStepBE	emType_GetUint16ArrayStepBE
+#define	GetUint16ArrayStepLE	emType_GetUint16ArrayStepLE
+#define	GetInt32Array			emType_GetInt32Array
+#define	GetInt32ArrayBE			emType_GetInt32ArrayBE
+#define	GetInt32ArrayLE			emType_GetInt32ArrayLE
+#define	GetInt32ArrayStep		emType_GetInt32ArrayStep
+#define	GetInt32ArrayStepBE		emType_GetInt32ArrayStepBE
+#define	GetInt32ArrayStepLE		emType_GetInt32ArrayStepLE
+#define	GetUint32Array			emType_GetUint32Array
+#define	GetUint32ArrayBE		emType_GetUint32ArrayBE
+#define	GetUint32ArrayLE		emType_GetUint32ArrayLE
+#define	GetUint32ArrayStep		emType_GetUint32ArrayStep
+#define	GetUint32ArrayStepBE	emType_GetUint32ArrayStepBE
+#define	GetUint32ArrayStepLE	emType_GetUint32ArrayStepLE
+#define	GetInt64Array			emType_GetInt64Array
+#define	GetInt64ArrayBE			emType_GetInt64ArrayBE
+#define	GetInt64ArrayLE			emType_GetInt64ArrayLE
+#define	GetInt64ArrayStep		emType_GetInt64ArrayStep
+#define	GetInt64ArrayStepBE		emType_GetInt64ArrayStepBE
+#define	GetInt64ArrayStepLE		emType_GetInt64ArrayStepLE
+#define	GetUint64Array			emType_GetUint64Array
+#define	GetUint64ArrayBE		emType_GetUint64ArrayBE
+#define	GetUint64ArrayLE		emType_GetUint64ArrayLE
+#define	GetUint64ArrayStep		emType_GetUint64ArrayStep
+#define	GetUint64ArrayStepBE	emType_GetUint64ArrayStepBE
+#define	GetUint64ArrayStepLE	emType_GetUint64ArrayStepLE
+#define	GetFloatArray			emType_GetFloatArray
+#define	GetFloatArrayBE			emType_GetFloatArrayBE
+#define	GetFloatArrayLE			emType_GetFloatArrayLE
+#define	GetFloatArrayStep		emType_GetFloatArrayStep
+#define	GetFloatArrayStepBE		emType_GetFloatArrayStepBE
+#define	GetFloatArrayStepLE		emType_GetFloatArrayStepLE
+#define	GetDoubleArray			emType_GetDoubleArray
+#define	GetDoubleArrayBE		emType_GetDoubleArrayBE
+#define	GetDoubleArrayLE		emType_GetDoubleArrayLE
+#define	GetDoubleArrayStep		emType_GetDoubleArrayStep
+#define	GetDoubleArrayStepBE	emType_GetDoubleArrayStepBE
+#define	GetDoubleArrayStepLE	emType_GetDoubleArrayStepLE
+#define	PutShortArray			emType_PutShortArray
+#define	PutShortArrayBE			emType_PutShortArrayBE
+#define	PutShortArrayLE			emType_PutShortArrayLE
+#define	PutShortArrayStep		emType_PutShortArrayStep
+#define	PutShortArrayStepBE		emType_PutShortArrayStepBE
+#define	PutShortArrayStepLE		emType_PutShortArrayStepLE
+#define	PutUshortArray			emType_PutUshortArray
+#define	PutUshortArrayBE		emType_PutUshortArrayBE
+#define	PutUshortArrayLE		emType_PutUshortArrayLE
+#define	PutUshortArrayStep		emType_PutUshortArrayStep
+#define	PutUshortArrayStepBE	emType_PutUshortArrayStepBE
+#define	PutUshortArrayStepLE	emType_PutUshortArrayStepLE
+#define	PutInt16Array			emType_PutInt16Array
+#define	PutInt16ArrayBE			emType_PutInt16ArrayBE
+#define	PutInt16ArrayLE			emType_PutInt16ArrayLE
+#define	PutInt16ArrayStep		emType_PutInt16ArrayStep
+#define	PutInt16ArrayStepBE		emType_PutInt16ArrayStepBE
+#define	PutInt16ArrayStepLE		emType_PutInt16ArrayStepLE
+#define	PutUint16Array			emType_PutUint16Array
+#define	PutUint16ArrayBE		emType_PutUint16ArrayBE
+#define	PutUint16ArrayLE		emType_PutUint16ArrayLE
+#define	PutUint16ArrayStep		emType_PutUint16ArrayStep
+#define	PutUint16ArrayStepBE	emType_PutUint16ArrayStepBE
+#define	PutUint16ArrayStepLE	emType_PutUint16ArrayStepLE
+#define	PutInt32Array			emType_PutInt32Array
+#define	PutInt32ArrayBE			emType_PutInt32ArrayBE
+#define	PutInt32ArrayLE			emType_PutInt32ArrayLE
+#define	PutInt32ArrayStep		emType_PutInt32ArrayStep
+#define	PutInt32ArrayStepBE		emType_PutInt32ArrayStepBE
+#define	PutInt32ArrayStepLE		emType_PutInt32ArrayStepLE
+#define	PutUint32Array			emType_PutUint32Array
+#define	PutUint32ArrayBE		emType_PutUint32ArrayBE
+#define	PutUint32ArrayLE		emType_PutUint32ArrayLE
+#define	PutUint32ArrayStep		emType_PutUint32ArrayStep
+#define	PutUint32ArrayStepBE	emType_PutUint32ArrayStepBE
+#define	PutUint32ArrayStepLE	emType_PutUint32ArrayStepLE
+#define	PutInt64Array			emType_PutInt64Array
+#define	PutInt64ArrayBE			emType_PutInt64ArrayBE
+#define	PutInt64ArrayLE			emType_PutInt64ArrayLE
+#define	PutInt64ArrayStep		emType_PutInt64ArrayStep
+#define	PutInt64ArrayStepBE		emType_PutInt64ArrayStepBE
+#define	PutInt64ArrayStepLE		emType_PutInt64ArrayStepLE
+#define	PutUint64Array			emType_PutUint64Array
+#define	PutUint64ArrayBE		emType_PutUint64ArrayBE
+#define	PutUint64ArrayLE		emType_PutUint64ArrayLE
+#define	PutUint64ArrayStep		emType_PutUint64ArrayStep
+#define	PutUint64ArrayStepBE	emType_PutUint64ArrayStepBE
+#define	PutUint64ArrayStepLE	emType_PutUint64ArrayStepLE
+#define	PutFloatArray			emType_PutFloatArray
+#define	PutFloatArrayBE			emType_PutFloatArrayBE
+#define	PutFloatArrayLE			emType_PutFloatArrayLE
+#define	PutFloatArrayStep		emType_PutFloatArrayStep
+#define	PutFloatArrayStepBE		emType_PutFloatArrayStepBE
+#define	PutFloatArrayStepLE		emType_PutFloatArrayStepLE
+#define	PutDoubleArray			emType_PutDoubleArray
+#define	PutDoubleArrayBE		emType_PutDoubleArrayBE
+#define	PutDoubleArrayLE		emType_PutDoubleArrayLE
+#define	PutDoubleArrayStep		emType_PutDoubleArrayStep
+#define	PutDoubleArrayStepBE	emType_PutDoubleArrayStepBE
+#define	PutDoubleArrayStepLE	emType_PutDoubleArrayStepLE
+#endif
+
+
+
+// Function:
+// BitReadInit(*cur, *src, off, bit_no, len)
+// BitReadInit(*cur, off, bit_no, len)
+// BitWriteInit(*cur, *dst, off, bit_no, len)
+// BitWriteInit(*cur, off, bit_no, len)
+// BitRead(*cur, width)
+// BitWrite(*cur, value, width)
+// BitFlush(*cur)
+// 
+// A bit cursor (emType_BitCursor) reads / writes fields of any width
+// (1 to 64 bits) back to back, starting at the specified bit number
+// (bit_no) from the specified address with offset (src + off or
+// dst + off), of length len bytes. Bits are numbered as in GetBit /
+// PutBit, and the first bit of a field is its least significant bit.
+// Up to 64 bits are buffered in the cursor, and are refilled / spilled
+// a word at a time. Bits read beyond the data are 0, and bits written
+// beyond it are dropped. Written bits reach the destination only on
+// BitFlush (or as the buffer fills up), and bits outside the written
+// fields are left unchanged. If address is not specified, then this
+// library's internal buffer is used.
+// 
+// Parameters:
+// cur:		the bit cursor
+// src:		the base address of stored data
+// dst:		the base address of destination
+// off:		offset from which bit index starts
+// bit_no:	the index of the first bit (starts from 0)
+// len:		length of data (in bytes, from src + off or dst + off)
+// value:	the value of field to be written
+// width:	width of the field (in bits)
+// 
+// Returns:
+// field_value:	the value of the field read (uint64, for BitRead)
+// 
+typedef struct _emType_BitCursor
+{
+	byte*	Data;
+	uint	Size;
+	uint	Byte;
+	uint64	Buf;
+	byte	Cnt;
+}emType_BitCursor;
+
+#define	emType_BitMask(width)	\
+	((((uint64)1) << (width)) - 1)
+
+static void emType_BitRefill(emType_BitCursor* cur)
+{
+	if(cur->Byte + 8 <= cur->Size)
+	{
+		cur->Buf |= emType_SwapLE64(emType_LoadBits64(cur->Data + cur->Byte)) << cur->Cnt;
+		cur->Byte += (63 - cur->Cnt) >> 3;
+		cur->Cnt |= 56;
+		return;
+	}
+	for(; cur->Cnt <= 56; cur->Cnt += 8, cur->Byte++)
+	{ if(cur->Byte < cur->Size) cur->Buf |= ((uint64)cur->Data[cur->Byte]) << cur->Cnt; }
+}
+
+static void emType_BitSpill(emType_BitCursor* cur)
+{
+	byte n = cur->Cnt >> 3;
+	uint64 buf = emType_SwapLE64(cur->Buf);
+	if(n == 0) return;
+	if(cur->Byte < cur->Size) memcpy(cur->Data + cur->Byte, &buf, (cur->Byte + n <= cur->Size)? n : cur->Size - cur->Byte);
+	cur->Byte += n;
+	cur->Buf = (n == 8)? 0 : cur->Buf >> (n << 3);
+	cur->Cnt -= n << 3;
+}
+
+uint64 emType_BitReadFn(emType_BitCursor* cur, byte width)
+{
+	uint64 value;
+	if(width > 56)
+	{
+		value = emType_BitReadFn(cur, 32);
+		return value | (emType_BitReadFn(cur, width - 32) << 32);
+	}
+	if(cur->Cnt < width) emType_BitRefill(cur);
+	value = cur->Buf & emType_BitMask(width);
+	cur->Buf >>= width;
+	cur->Cnt -= width;
+	return value;
+}
+
+void emType_BitWriteFn(emType_BitCursor* cur, uint64 value, byte width)
+{
+	if(width > 56)
+	{
+		emType_BitWriteFn(cur, value, 32);
+		emType_BitWriteFn(cur, value >> 32, width - 32);
+		return;
+	}
+	if(cur->Cnt + width > 64) emType_BitSpill(cur);
+	cur->Buf |= (value & emType_BitMask(width)) << cur->Cnt;
+	cur->Cnt += width;
+}
+
+void emType_BitFlushFn(emType_BitCursor* cur)
+{
+	byte msk;
+	emType_BitSpill(cur);
+	if(cur->Cnt == 0 || cur->Byte >= cur->Size) return;
+	msk = (byte)((1 << cur->Cnt) - 1);
+	cur->Data[cur->Byte] = (byte)((cur->Data[cur->Byte] & ~msk) | (cur->Buf & msk));
+}
+
+void emType_BitReadInitFn(emType_BitCursor* cur, byte* src, uint bit_no, uint len)
+{
+	cur->Data = src;
+	cur->Size = len;
+	cur->Byte = bit_no >> 3;
+	cur->Buf = 0;
+	cur->Cnt = 0;
+	emType_BitReadFn(cur, (byte)(bit_no & 7));
+}
+
+void emType_BitWriteInitFn(emType_BitCursor* cur, byte* dst, uint bit_no, uint len)
+{
+	cur->Data = dst;
+	cur->Size = len;
+	cur->Byte = bit_no >> 3;
+	cur->Cnt = (byte)(bit_no & 7);
+	cur->Buf = (cur->Cnt && cur->Byte < len)? (dst[cur->Byte] & emType_BitMask(cur->Cnt)) : 0;
+}
+
+#define	emType_BitReadInitExt(cur, src, off, bit_no, len)	\
+	emType_BitReadInitFn(cur, ((byte*)(src)) + (off), (uint)(bit_no), (uint)(len))
+
+#define	emType_BitReadInitInt(cur, off, bit_no, len)	\
+	emType_BitReadInitExt(cur, &emType, off, bit_no, len)
+
+#define	emType_BitReadInit(...)	\
+	Macro(Macro5(__VA_ARGS__, emType_BitReadInitExt, emType_BitReadInitInt)(__VA_ARGS__))
+
+#define	emType_BitWriteInitExt(cur, dst, off, bit_no, len)	\
+	emType_BitWriteInitFn(cur, ((byte*)(dst)) + (off), (uint)(bit_no), (uint)(len))
+
+#define	emType_BitWriteInitInt(cur, off, bit_no, len)	\
+	emType_BitWriteInitExt(cur, &emType, off, bit_no, len)
+
+#define	emType_BitWriteInit(...)	\
+	Macro(Macro5(__VA_ARGS__, emType_BitWriteInitExt, emType_BitWriteInitInt)(__VA_ARGS__))
+
+#define	emType_BitRead(cur, width)	\
+	emType_BitReadFn(cur, (byte)(width))
+
+#define	emType_BitWrite(cur, value, width)	\
+	emType_BitWriteFn(cur, (uint64)(value), (byte)(width))
+
+#define	emType_BitFlush(cur)	\
+	emType_BitFlushFn(cur)
+
+
+
+// Function:
+// BitUnpack(*dst, *src, off, bit_no, cnt, width)
+// BitUnpack(*dst, off, bit_no, cnt, width)
+// 
+// Unpacks a number of fields (cnt) of the specified width (1 to 16
+// bits), stored back to back from the specified bit number (bit_no)
+// of the source address with offset (src + off), into an array of
+// uint16 (dst). Byte aligned 12-bit fields are unpacked a pair (3
+// bytes) at a time, or 8 at a time on PC (SSSE3). If source address
+// is not specified, then this library's internal buffer is used.
+// 
+// Parameters:
+// dst:		the destination uint16 array
+// src:		the base address of stored data
+// off:		offset from which bit index starts
+// bit_no:	the index of the first bit (starts from 0)
+// cnt:		number of fields
+// width:	width of each field (in bits)
+// 
+// Returns:
+// nothing
+// 
+typedef uint (*emType_BitUnpackFnPtr)(uint16* dst, byte* src, uint cnt);
+
+static uint emType_BitUnpack12Scalar(uint16* dst, byte* src, uint cnt)
+{
+	uint i = 0;
+	for(; i + 2 <= cnt; i += 2, src += 3)
+	{
+		dst[i] = (uint16)(src[0] | ((src[1] & 0x0F) << 8));
+		dst[i + 1] = (uint16)((src[1] >> 4) | (src[2] << 4));
+	}
+	return i;
+}
+
+#if defined(emType_Dispatch) || defined(emType_SSSE3)
+emType_TargetSsse3 static uint emType_BitUnpack12Ssse3(uint16* dst, byte* src, uint cnt)
+{
+	uint i = 0;
+	__m128i shf = _mm_setr_epi8(0, 1, 1, 2, 3, 4, 4, 5, 6, 7, 7, 8, 9, 10, 10, 11);
+	__m128i lom = _mm_set1_epi32(0x00000FFF), him = _mm_set1_epi32((int)0xFFFF0000), v;
+	for(; i + 11 <= cnt; i += 8, src += 12)
+	{
+		v = _mm_shuffle_epi8(_mm_loadu_si128((__m128i*)src), shf);
+		v = _mm_or_si128(_mm_and_si128(v, lom), _mm_and_si128(_mm_srli_epi16(v, 4), him));
+		_mm_storeu_si128((__m128i*)(dst + i), v);
+	}
+	return i + emType_BitUnpack12Scalar(dst + i, src, cnt - i);
+}
+#endif
+
+#if defined(emType_Dispatch)
+static emType_BitUnpackFnPtr emType_BitUnpack12Select(void)
+{
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("ssse3")) return emType_BitUnpack12Ssse3;
+	return emType_BitUnpack12Scalar;
+}
+#elif defined(emType_SSSE3)
+#define	emType_BitUnpack12Select()	emType_BitUnpack12Ssse3
+#else
+#define	emType_BitUnpack12Select()	emType_BitUnpack12Scalar
+#endif
+
+void emType_BitUnpackFn(uint16* dst, byte* src, uint bit_no, uint cnt, byte width)
+{
+	static const emType_BitUnpackFnPtr unpack12 = emType_BitUnpack12Select();
+	emType_BitCursor cur;
+	uint i = 0;
+	if(width == 12 && (bit_no & 7) == 0) i = unpack12(dst, src + (bit_no >> 3), cnt);
+	emType_BitReadInitFn(&cur, src, bit_no + i * width, (bit_no + cnt * width + 7) >> 3);
+	for(; i<cnt; i++)
+	{ dst[i] = (uint16)emType_BitReadFn(&cur, width); }
+}
+
+#define	emType_BitUnpackExt(dst, src, off, bit_no, cnt, width)	\
+	emType_BitUnpackFn((uint16*)(dst), ((byte*)(src)) + (off), (uint)(bit_no), (uint)(cnt), (byte)(width))
+
+#define	emType_BitUnpackInt(dst, off, bit_no, cnt, width)	\
+	emType_BitUnpackExt(dst, &emType, off, bit_no, cnt, width)
+
+#define	emType_BitUnpack(...)	\
+	Macro(Macro6(__VA_ARGS__, emType_BitUnpackExt, emType_BitUnpackInt)(__VA_ARGS__))
+
+#if emType_Shorthand >= 1
+#define	type_BitCursor			emType_BitCursor
+#define	type_BitReadInit		emType_BitReadInit
+#define	type_BitWriteInit		emType_BitWriteInit
+#define	type_BitRead			emType_BitRead
+#define	type_BitWrite			emType_BitWrite
+#define	type_BitFlush			emType_BitFlush
+#define	type_BitUnpack			emType_BitUnpack
+#endif
+
+#if	emType_Shorthand >= 2
+#define	typBitCursor			emType_BitCursor
+#define	typBitReadInit			emType_BitReadInit
+#define	typBitWriteInit			emType_BitWriteInit
+#define	typBitRead				emType_BitRead
+#define	typBitWrite				emType_BitWrite
+#define	typBitFlush				emType_BitFlush
+#define	typBitUnpack			emType_BitUnpack
+#endif
+
+#if	emType_Shorthand >= 3
+#define	BitCursor				emType_BitCursor
+#define	BitReadInit				emType_BitReadInit
+#define	BitWriteInit			emType_BitWriteInit
+#define	BitRead					emType_BitRead
+#define	BitWrite				emType_BitWrite
+#define	BitFlush				emType_BitFlush
+#define	BitUnpack				emType_BitUnpack
+#endif
+
+
+
+// Function:
+// GetNibbleArray(*dst, *src, off, nibble_no, cnt)
+// GetNibbleArray(*dst, off, nibble_no, cnt)
+// PutNibbleArray(*dst, off, nibble_no, *src, cnt)
+// PutNibbleArray(off, nibble_no, *src, cnt)
+// 
+// Expands a number of nibbles (cnt) starting at the specified nibble
+// number (nibble_no) from the source address with offset (src + off)
+// into an array of bytes (dst), or packs an array of bytes (src) back
+// into nibbles at the destination address with offset (dst + off).
+// Nibbles are numbered as in GetNibble / PutNibble, and nibbles outside
+// the packed ones are left unchanged. On PC, 32 nibbles are expanded /
+// packed at a time (SSE2). If address is not specified, then this
+// library's internal buffer is used.
+// 
+// Parameters:
+// dst:			the destination byte array (Get) / base address of destination (Put)
+// src:			the base address of stored data (Get) / the source byte array (Put)
+// off:			offset from which nibble index starts
+// nibble_no:	the index of the first nibble (starts from 0)
+// cnt:			number of nibbles
+// 
+// Returns:
+// nothing
+// 
+void emType_GetNibbleArrayFn(byte* dst, byte* src, uint nibble_no, uint cnt)
+{
+	uint i = 0;
+	src += nibble_no >> 1;
+	if((nibble_no & 1) && cnt) { dst[i++] = *src >> 4; src++; }
+#if defined(emType_SSE2)
+	__m128i msk = _mm_set1_epi8(0x0F), v, lo, hi;
+	for(; i + 32 <= cnt; i += 32, src += 16)
+	{
+		v = _mm_loadu_si128((__m128i*)src);
+		lo = _mm_and_si128(v, msk);
+		hi = _mm_and_si128(_mm_srli_epi16(v, 4), msk);
+		_mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi8(lo, hi));
+		_mm_storeu_si128((__m128i*)(dst + i + 16), _mm_unpackhi_epi8(lo, hi));
+	}
+#endif
+	for(; i + 1 < cnt; i += 2, src++)
+	{
+		dst[i] = *src & 0xF;
+		dst[i + 1] = *src >> 4;
+	}
+	if(i < cnt) dst[i] = *src & 0xF;
+}
+
+void emType_PutNibbleArrayFn(byte* dst, uint nibble_no, byte* src, uint cnt)
+{
+	uint i = 0;
+	dst += nibble_no >> 1;
+	if((nibble_no & 1) && cnt) { *dst = (byte)((*dst & 0x0F) | (src[i++] << 4)); dst++; }
+#if defined(emType_SSE2)
+	__m128i msk = _mm_set1_epi16(0x0F0F), low = _mm_set1_epi16(0x00FF), a, b;
+	for(; i + 32 <= cnt; i += 32, dst += 16)
+	{
+		a = _mm_and_si128(_mm_loadu_si128((__m128i*)(src + i)), msk);
+		b = _mm_and_si128(_mm_loadu_si128((__m128i*)(src + i + 16)), msk);
+		a = _mm_and_si128(_mm_or_si128(a, _mm_srli_epi16(a, 4)), low);
+		b = _mm_and_si128(_mm_or_si128(b, _mm_srli_epi16(b, 4)), low);
+		_mm_storeu_si128((__m128i*)dst, _mm_packus_epi16(a, b));
+	}
+#endif
+	for(; i + 1 < cnt; i += 2, dst++)
+	{ *dst = (byte)((src[i] & 0xF) | (src[i + 1] << 4)); }
+	if(i < cnt) *dst = (byte)((*dst & 0xF0) | (src[i] & 0xF));
+}
+
+#define	emType_GetNibbleArrayExt(dst, src, off, nibble_no, cnt)	\
+	emType_GetNibbleArrayFn((byte*)(dst), ((byte*)(src)) + (off), (uint)(nibble_no), (uint)(cnt))
+
+#define	emType_GetNibbleArrayInt(dst, off, nibble_no, cnt)	\
+	emType_GetNibbleArrayExt(dst, &emType, off, nibble_no, cnt)
+
+#define	emType_GetNibbleArray(...)	\
+	Macro(Macro5(__VA_ARGS__, emType_GetNibbleArrayExt, emType_GetNibbleArrayInt)(__VA_ARGS__))
+
+#define	emType_PutNibbleArrayExt(dst, off, nibble_no, src, cnt)	\
+	emType_PutNibbleArrayFn(((byte*)(dst)) + (off), (uint)(nibble_no), (byte*)(src), (uint)(cnt))
+
+#define	emType_PutNibbleArrayInt(off, nibble_no, src, cnt)	\
+	emType_PutNibbleArrayExt(&emType, off, nibble_no, src, cnt)
+
+#define	emType_PutNibbleArray(...)	\
+	Macro(Macro5(__VA_ARGS__, emType_PutNibbleArrayExt, emType_PutNibbleArrayInt)(__VA_ARGS__))
+
+
+
+// Function:
+// GetBcdArray(*dst, *src, off, cnt)
+// GetBcdArray(*dst, off, cnt)
+// PutBcdArray(*dst, off, *src, cnt)
+// PutBcdArray(off, *src, cnt)
+// 
+// Converts a number of packed BCD bytes (cnt) at the source address
+// with offset (src + off) into binary bytes (0 to 99) in an array
+// (dst), or converts an array of binary bytes (src) into packed BCD
+// bytes at the destination address with offset (dst + off). The high
+// nibble of a BCD byte holds the tens digit. On PC, 16 bytes are
+// converted at a time (SSE2). If address is not specified, then this
+// library's internal buffer is used.
+// 
+// Parameters:
+// dst:		the destination byte array (Get) / base address of destination (Put)
+// src:		the base address of stored data (Get) / the source byte array (Put)
+// off:		offset of the first BCD byte
+// cnt:		number of bytes
+// 
+// Returns:
+// status:	0 for success, 0xFF for invalid BCD digit / binary value above 99
+// 
+byte emType_GetBcdArrayFn(byte* dst, byte* src, uint cnt)
+{
+	uint i = 0;
+	byte lo, hi, bad = 0;
+#if defined(emType_SSE2)
+	__m128i msk = _mm_set1_epi8(0x0F), nin = _mm_set1_epi8(9), err = _mm_setzero_si128(), v, l, h;
+	for(; i + 16 <= cnt; i += 16)
+	{
+		v = _mm_loadu_si128((__m128i*)(src + i));
+		l = _mm_and_si128(v, msk);
+		h = _mm_and_si128(_mm_srli_epi16(v, 4), msk);
+		err = _mm_or_si128(err, _mm_or_si128(_mm_cmpgt_epi8(l, nin), _mm_cmpgt_epi8(h, nin)));
+		v = _mm_add_epi8(_mm_add_epi8(_mm_slli_epi16(h, 3), _mm_add_epi8(h, h)), l);
+		_mm_storeu_si128((__m128i*)(dst + i), v);
+	}
+	if(_mm_movemask_epi8(err)) bad = 0xFF;
+#endif
+	for(; i<cnt; i++)
+	{
+		lo = src[i] & 0xF;
+		hi = src[i] >> 4;
+		if(lo > 9 || hi > 9) bad = 0xFF;
+		dst[i] = (byte)(hi * 10 + lo);
+	}
+	return bad;
+}
+
+byte emType_PutBcdArrayFn(byte* dst, byte* src, uint cnt)
+{
+	uint i = 0;
+	byte ten, bad = 0;
+#if defined(emType_SSE2)
+	__m128i mul = _mm_set1_epi16(6554), dec = _mm_set1_epi16(10), max = _mm_set1_epi16(99), zro = _mm_setzero_si128();
+	__m128i err = zro, v, w[2], t;
+	uint k;
+	for(; i + 16 <= cnt; i += 16)
+	{
+		v = _mm_loadu_si128((__m128i*)(src + i));
+		w[0] = _mm_unpacklo_epi8(v, zro);
+		w[1] = _mm_unpackhi_epi8(v, zro);
+		for(k=0; k<2; k++)
+		{
+			err = _mm_or_si128(err, _mm_cmpgt_epi16(w[k], max));
+			t = _mm_mulhi_epu16(w[k], mul);
+			w[k] = _mm_or_si128(_mm_slli_epi16(t, 4), _mm_sub_epi16(w[k], _mm_mullo_epi16(t, dec)));
+		}
+		_mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(w[0], w[1]));
+	}
+	if(_mm_movemask_epi8(err)) bad = 0xFF;
+#endif
+	for(; i<cnt; i++)
+	{
+		if(src[i] > 99) bad = 0xFF;
+		ten = src[i] / 10;
+		dst[i] = (byte)((ten << 4) | (src[i] - ten * 10));
+	}
+	return bad;
+}
+
+#define	emType_GetBcdArrayExt(dst, src, off, cnt)	\
+	emType_GetBcdArrayFn((byte*)(dst), ((byte*)(src)) + (off), (uint)(cnt))
+
+#define	emType_GetBcdArrayInt(dst, off, cnt)	\
+	emType_GetBcdArrayExt(dst, &emType, off, cnt)
+
+#define	emType_GetBcdArray(...)	\
+	Macro(Macro4(__VA_ARGS__, emType_GetBcdArrayExt, emType_GetBcdArrayInt)(__VA_ARGS__))
+
+#define	emType_PutBcdArrayExt(dst, off, src, cnt)	\
+	emType_PutBcdArrayFn(((byte*)(dst)) + (off), (byte*)(src), (uint)(cnt))
+
+#define	emType_PutBcdArrayInt(off, src, cnt)	\
+	emType_PutBcdArrayExt(&emType, off, src, cnt)
+
+#define	emType_PutBcdArray(...)	\
+	Macro(Macro4(__VA_ARGS__, emType_PutBcdArrayExt, emType_PutBcdArrayInt)(__VA_ARGS__))
+
+#if emType_Shorthand >= 1
+#define	type_GetNibbleArray		emType_GetNibbleArray
+#define	type_PutNibbleArray		emType_PutNibbleArray
+#define	type_GetBcdArray		emType_GetBcdArray
+#define	type_PutBcdArray		emType_PutBcdArray
+#endif
+
+#if	emType_Shorthand >= 2
+#define	typGetNibbleArray		emType_GetNibbleArray
+#define	typPutNibbleArray		emType_PutNibbleArray
+#define	typGetBcdArray			emType_GetBcdArray
+#define	typPutBcdArray			emType_PutBcdArray
+#endif
+
+#if	emType_Shorthand >= 3
+#define	GetNibbleArray			emType_GetNibbleArray
+#define	PutNibbleArray			emType_PutNibbleArray
+#define	GetBcdArray				emType_GetBcdArray
+#define	PutBcdArray				emType_PutBcdArray
+#endif
+
+
+
+// Function:
+// DoReverse(*src, off, len)
+// DoReverse(off, len)
+// 
+// Reverses the data stored at the source address (src + off)
+// of specified length (len). The data at the source is directly
+// reversed, and hence if the original data is required, then
+// it is suggested to make a copy of it. If source base address
+// is not specified, this library's internal buffer is assumed
+// as the source base address. Blocks are taken from both ends
+// and swapped after reversing them in register, 32 / 16 / 8
+// bytes at a time (AVX2, SSSE3, SSE2 or 64-bit words) on PC.
+// 
+// Parameters:
+// src:		the base address of source data
+// off:		offset to the actual data to be reversed (src + off)
+// len:		length of data to be reversed
+// 
+// Returns:
+// nothing
+// 
+typedef void (*emType_DoReverseFnPtr)(byte* lo, byte* hi);
+
+static void emType_DoReverseScalar(byte* lo, byte* hi)
+{
+	byte byt;
+#if embd_Platform == embd_PlatformPC
+	uint64 a, b;
+	for(; hi - lo >= 16; lo += 8)
+	{
+		hi -= 8;
+		a = emType_LoadBits64(lo);
+		b = emType_LoadBits64(hi);
+		emType_StoreBits64(lo, emType_Swap64(b));
+		emType_StoreBits64(hi, emType_Swap64(a));
+	}
+#endif
+	for(hi--; lo < hi; lo++, hi--)
+	{
+		byt = *lo;
+		*lo = *hi;
+		*hi = byt;
+	}
+}
+
+#if defined(emType_Dispatch) || defined(emType_SSE2)
+emType_TargetSse2 static void emType_DoReverseSse2(byte* lo, byte* hi)
+{
+	__m128i a, b;
+	for(; hi - lo >= 32; lo += 16)
+	{
+		hi -= 16;
+		a = _mm_loadu_si128((__m128i*)lo);
+		b = _mm_loadu_si128((__m128i*)hi);
+		a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(_mm_shuffle_epi32(a, 0x1B), 0xB1), 0xB1);
+		b = _mm_shufflehi_epi16(_mm_shufflelo_epi16(_mm_shuffle_epi32(b, 0x1B), 0xB1), 0xB1);
+		a = _mm_or_si128(_mm_slli_epi16(a, 8), _mm_srli_epi16(a, 8));
+		b = _mm_or_si128(_mm_slli_epi16(b, 8), _mm_srli_epi16(b, 8));
+		_mm_storeu_si128((__m128i*)lo, b);
+		_mm_storeu_si128((__m128i*)hi, a);
+	}
+	emType_DoReverseScalar(lo, hi);
+}
+#endif
+
+#if defined(emType_Dispatch) || defined(emType_SSSE3)
+emType_TargetSsse3 static void emType_DoReverseSsse3(byte* lo, byte* hi)
+{
+	__m128i a, b, mask = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+	for(; hi - lo >= 32; lo += 16)
+	{
+		hi -= 16;
+		a = _mm_loadu_si128((__m128i*)lo);
+		b = _mm_loadu_si128((__m128i*)hi);
+		_mm_storeu_si128((__m128i*)lo, _mm_shuffle_epi8(b, mask));
+		_mm_storeu_si128((__m128i*)hi, _mm_shuffle_epi8(a, mask));
+	}
+	emType_DoReverseScalar(lo, hi);
+}
+#endif
+
+#if defined(emType_Dispatch) || defined(emType_AVX2)
+emType_TargetAvx2 static void emType_DoReverseAvx2(byte* lo, byte* hi)
+{
+	__m256i a, b, mask = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+		15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+	for(; hi - lo >= 64; lo += 32)
+	{
+		hi -= 32;
+		a = _mm256_loadu_si256((__m256i*)lo);
+		b = _mm256_loadu_si256((__m256i*)hi);
+		_mm256_storeu_si256((__m256i*)lo, _mm256_permute4x64_epi64(_mm256_shuffle_epi8(b, mask), 0x4E));
+		_mm256_storeu_si256((__m256i*)hi, _mm256_permute4x64_epi64(_mm256_shuffle_epi8(a, mask), 0x4E));
+	}
+	// SSE code that follows stalls while the upper halves of ymm registers are dirty
+	_mm256_zeroupper();
+	emType_DoReverseSsse3(lo, hi);
+}
+#endif
+
+#if defined(emType_Dispatch)
+static emType_DoReverseFnPtr emType_DoReverseSelect(void)
+{
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2")) return emType_DoReverseAvx2;
+	if(__builtin_cpu_supports("ssse3")) return emType_DoReverseSsse3;
+	if(__builtin_cpu_supports("sse2")) return emType_DoReverseSse2;
+	return emType_DoReverseScalar;
+}
+#elif defined(emType_AVX2)
+#define	emType_DoReverseSelect()	emType_DoReverseAvx2
+#elif defined(emType_SSSE3)
+#define	emType_DoReverseSelect()	emType_DoReverseSsse3
+#elif defined(emType_SSE2)
+#define	emType_DoReverseSelect()	emType_DoReverseSse2
+#else
+#define	emType_DoReverseSelect()	emType_DoReverseScalar
+#endif
+
+void emType_DoReverseExtFn(byte* src, int off, int len)
+{
+	static const emType_DoReverseFnPtr reverse = emType_DoReverseSelect();
+	if(len > 1) reverse(src + off, src + off + len);
+}
+
+#define	emType_DoReverseExt(src, off, len)	\
+	emType_DoReverseExtFn((byte*)(src), (int)(off), (int)(len))
+
+#define	emType_DoReverseInt(off, len)	\
+	emType_DoReverseExt(&emType, off, len)
+
+#define	emType_DoReverse(...)	\
+	Macro(Macro3(__VA_ARGS__, emType_DoReverseExt, emType_DoReverseInt)(__VA_ARGS__))
+
+#if emType_Shorthand >= 1
+#define	type_DoReverse			emType_DoReverse
+#endif
+
+#if	emType_Shorthand >= 2
+#define	typDoReverse			emType_DoReverse
+#endif
+
+#if	emType_Shorthand >= 3
+#define	DoReverse				emType_DoReverse
+#endif
+
+
+
+// Function:
+// Get<Byte/Uint8/Ushort/Uint16>Sum(*src, off, len)
+// Get<Byte/Uint8/Ushort/Uint16>Sum(off, len)
+// 
+// Finds the sum of all bytes/ushorts at the specified source
+// address (src + off) of the specified length (len). If source
+// base address is not specified, this library's internal buffer
+// is assumed as the source base address. This can be used to
+// calculate checksums. The source need not be aligned, and a
+// trailing odd byte is summed as a ushort padded with zero (so
+// that a sum can also be made chunk by chunk, see SumNext). On
+// PC, 32 / 16 bytes are added at a time (AVX2 / SSE2), as
+// wrapping lane sums are exact modulo the size of the result.
+// 
+// Parameters:
+// src:		the base address of source data
+// off:		offset to the data to be summed (src + off)
+// len:		length of data to be summed (in bytes)
+// 
+// Returns:
+// <type>_value:  the summed value
+// 
+typedef uint (*emType_GetSumFnPtr)(byte* src, uint len);
+
+static uint emType_GetByteSumScalar(byte* src, uint len)
+{
+	uint sum = 0;
+	for(; len>0; len--, src++)
+	{ sum += *src; }
+	return sum;
+}
+
+static uint emType_GetUshortSumScalar(byte* src, uint cnt)
+{
+	uint sum = 0;
+	for(; cnt>0; cnt--, src += 2)
+	{ sum += emType_LoadBits16(src); }
+	return sum;
+}
+
+#if defined(emType_Dispatch) || defined(emType_SSE2)
+emType_TargetSse2 static uint emType_GetByteSumSse2(byte* src, uint len)
+{
+	uint i = 0;
+	__m128i sum = _mm_setzero_si128();
+	for(; i + 16 <= len; i += 16)
+		sum = _mm_add_epi8(sum, _mm_loadu_si128((__m128i*)(src + i)));
+	sum = _mm_sad_epu8(sum, _mm_setzero_si128());
+	return (uint)(_mm_cvtsi128_si32(sum) + _mm_extract_epi16(sum, 4)) + emType_GetByteSumScalar(src + i, len - i);
+}
+
+emType_TargetSse2 static uint emType_GetUshortSumSse2(byte* src, uint cnt)
+{
+	uint i = 0;
+	__m128i sum = _mm_setzero_si128();
+	for(; i + 8 <= cnt; i += 8)
+		sum = _mm_add_epi16(sum, _mm_loadu_si128((__m128i*)(src + i * 2)));
+	sum = _mm_add_epi16(sum, _mm_srli_si128(sum, 8));
+	sum = _mm_add_epi16(sum, _mm_srli_si128(sum, 4));
+	sum = _mm_add_epi16(sum, _mm_srli_si128(sum, 2));
+	return (uint)_mm_extract_epi16(sum, 0) + emType_GetUshortSumScalar(src + i * 2, cnt - i);
+}
+#endif
+
+#if defined(emType_Dispatch) || defined(emType_AVX2)
+emType_TargetAvx2 static uint emType_GetByteSumAvx2(byte* src, uint len)
+{
+	uint i = 0, val;
+	__m256i sum = _mm256_setzero_si256();
+	for(; i + 32 <= len; i += 32)
+		sum = _mm256_add_epi8(sum, _mm256_loadu_si256((__m256i*)(src + i)));
+	sum = _mm256_sad_epu8(sum, _mm256_setzero_si256());
+	val = (uint)(_mm256_extract_epi32(sum, 0) + _mm256_extract_epi32(sum, 2) + _mm256_extract_epi32(sum, 4) + _mm256_extract_epi32(sum, 6));
+	// the SSE2 code that follows stalls while the upper halves of ymm registers are dirty
+	_mm256_zeroupper();
+	return val + emType_GetByteSumSse2(src + i, len - i);
+}
+
+emType_TargetAvx2 static uint emType_GetUshortSumAvx2(byte* src, uint cnt)
+{
+	uint i = 0;
+	__m128i part;
+	__m256i sum = _mm256_setzero_si256();
+	for(; i + 16 <= cnt; i += 16)
+		sum = _mm256_add_epi16(sum, _mm256_loadu_si256((__m256i*)(src + i * 2)));
+	part = _mm_add_epi16(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+	part = _mm_add_epi16(part, _mm_srli_si128(part, 8));
+	part = _mm_add_epi16(part, _mm_srli_si128(part, 4));
+	part = _mm_add_epi16(part, _mm_srli_si128(part, 2));
+	_mm256_zeroupper();
+	return (uint)_mm_extract_epi16(part, 0) + emType_GetUshortSumSse2(src + i * 2, cnt - i);
+}
+#endif
+
+#if defined(emType_Dispatch)
+static emType_GetSumFnPtr emType_GetByteSumSelect(void)
+{
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2")) return emType_GetByteSumAvx2;
+	if(__builtin_cpu_supports("sse2")) return emType_GetByteSumSse2;
+	return emType_GetByteSumScalar;
+}
+
+static emType_GetSumFnPtr emType_GetUshortSumSelect(void)
+{
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2")) return emType_GetUshortSumAvx2;
+	if(__builtin_cpu_supports("sse2")) return emType_GetUshortSumSse2;
+	return emType_GetUshortSumScalar;
+}
+#elif defined(emType_AVX2)
+#define	emType_GetByteSumSelect()	emType_GetByteSumAvx2
+#define	emType_GetUshortSumSelect()	emType_GetUshortSumAvx2
+#elif defined(emType_SSE2)
+#define	emType_GetByteSumSelect()	emType_GetByteSumSse2
+#define	emType_GetUshortSumSelect()	emType_GetUshortSumSse2
+#else
+#define	emType_GetByteSumSelect()	emType_GetByteSumScalar
+#define	emType_GetUshortSumSelect()	emType_GetUshortSumScalar
+#endif
+
+byte emType_GetByteSumExtFn(byte* src, int off, int len)
+{
+	static const emType_GetSumFnPtr sum = emType_GetByteSumSelect();
+	return (len > 0)? (byte)sum(src + off, (uint)len) : 0;
+}
+
+#define	emType_GetByteSumExt(src, off, len)	\
+	emType_GetByteSumExtFn((byte*)(src), (int)(off), (int)(len))
+
+#define	emType_GetByteSumInt(off, len)	\
+	emType_GetByteSumExt(&emType, off, len)
+
+#define	emType_GetByteSum(...)	\
+	Macro(Macro3(__VA_ARGS__, emType_GetByteSumExt, emType_GetByteSumInt)(__VA_ARGS__))
+
+#define	emType_GetUint8Sum	\
+	emType_GetByteSum
+
+#if emType_LittleEndian
+#define	emType_SumLowByte(byt)		((ushort)(byt))
+#define	emType_SumHighByte(byt)		((ushort)((byt) << 8))
+#else
+#define	emType_SumLowByte(byt)		((ushort)((byt) << 8))
+#define	emType_SumHighByte(byt)		((ushort)(byt))
+#endif
+
+ushort emType_GetUshortSumExtFn(byte* src, int off, int len)
+{
+	static const emType_GetSumFnPtr sum = emType_GetUshortSumSelect();
+	ushort val = (len > 1)? (ushort)sum(src + off, (uint)len >> 1) : 0;
+	if(len > 0 && (len & 1)) val += emType_SumLowByte(src[off + len - 1]);
+	return val;
+}
+
+#define	emType_GetUshortSumExt(src, off, len)	\
+	emType_GetUshortSumExtFn((byte*)(src), (int)(off), (int)(len))
+
+#define	emType_GetUshortSumInt(off, len)	\
+	emType_GetUshortSumExt(&emType, off, len)
+
+#define	emType_GetUshortSum(...)	\
+	Macro(Macro3(__VA_ARGS__, emType_GetUshortSumExt, emType_GetUshortSumInt)(__VA_ARGS__))
+
+#define	emType_GetUint16Sum		emType_GetUshortSum
+
+#if emType_Shorthand >= 1
+#define	type_GetByteSum			emType_GetByteSum
+#define	type_GetUint8Sum		emType_GetUint8Sum
+#define	type_GetUshortSum		emType_GetUshortSum
+#define	type_GetUint16Sum		emType_GetUint16Sum
+#endif
+
+#if	emType_Shorthand >= 2
+#define	typGetByteSum			emType_GetByteSum
+#define	typGetUint8Sum			emType_GetUint8Sum
+#define	typGetUshortSum			emType_GetUshortSum
+#define	typGetUint16Sum			emType_GetUint16Sum
+#endif
+
+#if	emType_Shorthand >= 3
+#define	GetByteSum				emType_GetByteSum
+#define	GetUint8Sum				emType_GetUint8Sum
+#define	GetUshortSum			emType_GetUshortSum
+#define	GetUint16Sum			emType_GetUint16Sum
+#endif
+
+
+
+// Function:
+// Get<Byte/Uint8>SumNext(sum, *src, off, len)
+// Get<Byte/Uint8>SumNext(sum, off, len)
+// Get<Ushort/Uint16>SumNext(sum, pos, *src, off, len)
+// Get<Ushort/Uint16>SumNext(sum, pos, off, len)
+// 
+// Updates a running byte/ushort sum with the next chunk of data
+// at the specified source address (src + off) of the specified
+// length (len). This allows a checksum to be computed as the data
+// arrives in pieces (say, from a stream), without buffering all of
+// it. For ushort sums, the position of the chunk in the whole data
+// (pos, number of bytes summed before) is also required, as chunks
+// may start or end in the middle of a ushort. The result is the
+// same as that of Get<Type>Sum() over the whole data. If source
+// base address is not specified, this library's internal buffer
+// is assumed as the source base address.
+// 
+// Parameters:
+// sum:		the sum of data so far (0 initially)
+// pos:		position of this chunk in the whole data
+// src:		the base address of source data
+// off:		offset to the data to be summed (src + off)
+// len:		length of data to be summed (in bytes)
+// 
+// Returns:
+// <type>_value:  the updated sum
+// 
+#define	emType_GetByteSumNextExt(sum, src, off, len)	\
+	((byte)((sum) + emType_GetByteSumExt(src, off, len)))
+
+#define	emType_GetByteSumNextInt(sum, off, len)	\
+	emType_GetByteSumNextExt(sum, &emType, off, len)
+
+#define	emType_GetByteSumNext(...)	\
+	Macro(Macro4(__VA_ARGS__, emType_GetByteSumNextExt, emType_GetByteSumNextInt)(__VA_ARGS__))
+
+#define	emType_GetUint8SumNext	\
+	emType_GetByteSumNext
+
+ushort emType_GetUshortSumNextFn(ushort sum, uint pos, byte* src, int off, int len)
+{
+	src += off;
+	if((pos & 1) && len > 0)
+	{
+		sum += emType_SumHighByte(*src);
+		src++; len--;
+	}
+	sum += emType_GetUshortSumExtFn(src, 0, len);
+	return sum;
+}
+
+#define	emType_GetUshortSumNextExt(sum, pos, src, off, len)	\
+	emType_GetUshortSumNextFn((ushort)(sum), (uint)(pos), (byte*)(src), (int)(off), (int)(len))
+
+#define	emType_GetUshortSumNextInt(sum, pos, off, len)	\
+	emType_GetUshortSumNextExt(sum, pos, &emType, off, len)
+
+#define	emType_GetUshortSumNext(...)	\
+	Macro(Macro5(__VA_ARGS__, emType_GetUshortSumNextExt, emType_GetUshortSumNextInt)(__VA_ARGS__))
+
+#define	emType_GetUint16SumNext		emType_GetUshortSumNext
+
+#if emType_Shorthand >= 1
+#define	type_GetByteSumNext		emType_GetByteSumNext
+#define	type_GetUint8SumNext	emType_GetUint8SumNext
+#define	type_GetUshortSumNext	emType_GetUshortSumNext
+#define	type_GetUint16SumNext	emType_GetUint16SumNext
+#endif
+
+#if	emType_Shorthand >= 2
+#define	typGetByteSumNext		emType_GetByteSumNext
+#define	typGetUint8SumNext		emType_GetUint8SumNext
+#define	typGetUshortSumNext		emType_GetUshortSumNext
+#define	typGetUint16SumNext		emType_GetUint16SumNext
+#endif
+
+#if	emType_Shorthand >= 3
+#define	GetByteSumNext			emType_GetByteSumNext
+#define	GetUint8SumNext			emType_GetUint8SumNext
+#define	GetUshortSumNext		emType_GetUshortSumNext
+#define	GetUint16SumNext		emType_GetUint16SumNext
+#endif
+
+
+
+// Function:
+// GetCrc<16/32/32C>(*src, off, len)
+// GetCrc<16/32/32C>(off, len)
+// GetCrc<16/32/32C>Next(crc, *src, off, len)
+// GetCrc<16/32/32C>Next(crc, off, len)
+// 
+// Finds the CRC of data at the specified source address (src + off)
+// of the specified length (len). Unlike the byte / ushort sums, a CRC
+// also detects reordered bytes. The Next form updates the CRC of data
+// so far (crc, 0 initially) with the next chunk of data, so that it
+// can be computed as the data arrives in pieces. If source base
+// address is not specified, this library's internal buffer is assumed
+// as the source base address. The CRCs are:
+// 
+// CRC-16:	CRC-16/X-25 (poly 0x1021 reflected, init 0xFFFF, xorout 0xFFFF)
+// CRC-32:	CRC-32 (zip, ethernet) (poly 0x04C11DB7 reflected, init / xorout 0xFFFFFFFF)
+// CRC-32C:	CRC-32C (castagnoli) (poly 0x1EDC6F41 reflected, init / xorout 0xFFFFFFFF)
+// 
+// On PC, slicing-by-8 tables (built on first use) process 8 bytes at
+// a time, and CRC-32C / CRC-32 use the SSE4.2 crc32 instruction /
+// PCLMULQDQ folding when the CPU supports it. On other platforms,
+// CRCs are computed bitwise, as the tables would not fit in RAM.
+// 
+// Parameters:
+// crc:		the CRC of data so far (for Next)
+// src:		the base address of source data
+// off:		offset to the data (src + off)
+// len:		length of data (in bytes)
+// 
+// Returns:
+// crc_value:	the CRC of data (uint16 for CRC-16, else emType_Bits32)
+// 
+#define	emType_Crc16Poly		0x8408
+#define	emType_Crc32Poly		0xEDB88320
+#define	emType_Crc32CPoly		0x82F63B78
+
+typedef emType_Bits32 (*emType_CrcFnPtr)(emType_Bits32 crc, byte* src, uint len);
+
+#if embd_Platform == embd_PlatformPC
+typedef emType_Bits32 emType_CrcTable[8][256];
+
+static emType_CrcTable* emType_CrcTableInit(emType_CrcTable* tbl, emType_Bits32 poly)
+{
+	emType_Bits32 crc;
+	uint i, k;
+	for(i=0; i<256; i++)
+	{
+		for(crc = i, k = 0; k < 8; k++)
+		{ crc = (crc >> 1) ^ (poly & (0 - (crc & 1))); }
+		(*tbl)[0][i] = crc;
+	}
+	for(k=1; k<8; k++)
+	{
+		for(i=0; i<256; i++)
+		{ (*tbl)[k][i] = ((*tbl)[k - 1][i] >> 8) ^ (*tbl)[0][(*tbl)[k - 1][i] & 0xFF]; }
+	}
+	return tbl;
+}
+
+static emType_Bits32 emType_CrcSlice8(emType_CrcTable* tbl, emType_Bits32 crc, byte* src, uint len)
+{
+	uint64 v;
+	for(; len >= 8; len -= 8, src += 8)
+	{
+		v = emType_SwapLE64(emType_LoadBits64(src)) ^ crc;
+		crc = (*tbl)[7][v & 0xFF] ^ (*tbl)[6][(v >> 8) & 0xFF] ^ (*tbl)[5][(v >> 16) & 0xFF] ^ (*tbl)[4][(v >> 24) & 0xFF] ^
+			(*tbl)[3][(v >> 32) & 0xFF] ^ (*tbl)[2][(v >> 40) & 0xFF] ^ (*tbl)[1][(v >> 48) & 0xFF] ^ (*tbl)[0][v >> 56];
+	}
+	for(; len>0; len--, src++)
+	{ crc = (*tbl)[0][(crc ^ *src) & 0xFF] ^ (crc >> 8); }
+	return crc;
+}
+
+#define	emType_CrcSliceMake(name, poly)	\
+static emType_Bits32 emType_##name##Slice(emType_Bits32 crc, byte* src, uint len)	\
+{	\
+	static emType_CrcTable tbl;	\
+	static emType_CrcTable* const ptbl = emType_CrcTableInit(&tbl, poly);	\
+	return emType_CrcSlice8(ptbl, crc, src, len);	\
+}
+
+emType_CrcSliceMake(Crc16, emType_Crc16Poly)
+emType_CrcSliceMake(Crc32, emType_Crc32Poly)
+emType_CrcSliceMake(Crc32C, emType_Crc32CPoly)
+#else
+static emType_Bits32 emType_CrcBits(emType_Bits32 crc, emType_Bits32 poly, byte* src, uint len)
+{
+	byte k;
+	for(; len>0; len--, src++)
+	{
+		crc ^= *src;
+		for(k=0; k<8; k++)
+		{ crc = (crc >> 1) ^ (poly & (0 - (crc & 1))); }
+	}
+	return crc;
+}
+
+#define	emType_CrcSliceMake(name, poly)	\
+static emType_Bits32 emType_##name##Slice(emType_Bits32 crc, byte* src, uint len)	\
+{	\
+	return emType_CrcBits(crc, poly, src, len);	\
+}
+
+emType_CrcSliceMake(Crc16, emType_Crc16Poly)
+emType_CrcSliceMake(Crc32, emType_Crc32Poly)
+emType_CrcSliceMake(Crc32C, emType_Crc32CPoly)
+#endif
+
+#if defined(emType_Dispatch)
+__attribute__((target("sse4.2"))) static emType_Bits32 emType_Crc32CHw(emType_Bits32 crc, byte* src, uint len)
+{
+#if defined(__x86_64__)
+	uint64 crc64 = crc;
+	for(; len >= 8; len -= 8, src += 8)
+	{ crc64 = _mm_crc32_u64(crc64, emType_LoadBits64(src)); }
+	crc = (emType_Bits32)crc64;
+#endif
+	for(; len >= 4; len -= 4, src += 4)
+	{ crc = _mm_crc32_u32(crc, emType_LoadBits32(src)); }
+	for(; len>0; len--, src++)
+	{ crc = _mm_crc32_u8(crc, *src); }
+	return crc;
+}
+
+__attribute__((target("pclmul,sse4.1"))) static emType_Bits32 emType_Crc32Clmul(emType_Bits32 crc, byte* src, uint len)
+{
+	__m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, msk;
+	if(len < 64) return emType_Crc32Slice(crc, src, len);
+	// fold by 4 x 128 bits
+	x1 = _mm_xor_si128(_mm_loadu_si128((__m128i*)src), _mm_cvtsi32_si128((int)crc));
+	x2 = _mm_loadu_si128((__m128i*)(src + 16));
+	x3 = _mm_loadu_si128((__m128i*)(src + 32));
+	x4 = _mm_loadu_si128((__m128i*)(src + 48));
+	x0 = _mm_set_epi64x(0x01c6e41596LL, 0x0154442bd4LL);
+	for(src += 64, len -= 64; len >= 64; src += 64, len -= 64)
+	{
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+		x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+		x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+		x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+		x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((__m128i*)src));
+		x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((__m128i*)(src + 16)));
+		x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((__m128i*)(src + 32)));
+		x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((__m128i*)(src + 48)));
+	}
+	// fold into 128 bits
+	x0 = _mm_set_epi64x(0x00ccaa009eLL, 0x01751997d0LL);
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, x0, 0x11), x2), x5);
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, x0, 0x11), x3), x5);
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, x0, 0x11), x4), x5);
+	for(; len >= 16; src += 16, len -= 16)
+	{
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, x0, 0x11), _mm_loadu_si128((__m128i*)src)), x5);
+	}
+	// fold 128 to 64 bits
+	msk = _mm_setr_epi32(-1, 0, -1, 0);
+	x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+	x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+	x0 = _mm_set_epi64x(0, 0x0163cd6124LL);
+	x2 = _mm_srli_si128(x1, 4);
+	x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, msk), x0, 0x00), x2);
+	// barrett reduce to 32 bits
+	x0 = _mm_set_epi64x(0x01f7011641LL, 0x01db710641LL);
+	x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, msk), x0, 0x10);
+	x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, msk), x0, 0x00);
+	crc = (emType_Bits32)_mm_extract_epi32(_mm_xor_si128(x1, x2), 1);
+	return emType_Crc32Slice(crc, src, len);
+}
+
+static emType_CrcFnPtr emType_Crc32Select(void)
+{
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1")) return emType_Crc32Clmul;
+	return emType_Crc32Slice;
+}
+
+static emType_CrcFnPtr emType_Crc32CSelect(void)
+{
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("sse4.2")) return emType_Crc32CHw;
+	return emType_Crc32CSlice;
+}
+#else
+#define	emType_Crc32Select()	emType_Crc32Slice
+#define	emType_Crc32CSelect()	emType_Crc32CSlice
+#endif
+
+uint16 emType_GetCrc16NextFn(uint16 crc, byte* src, int len)
+{
+	if(len <= 0) return crc;
+	return (uint16)~emType_Crc16Slice((uint16)~crc, src, (uint)len);
+}
+
+emType_Bits32 emType_GetCrc32NextFn(emType_Bits32 crc, byte* src, int len)
+{
+	static const emType_CrcFnPtr crc32 = emType_Crc32Select();
+	if(len <= 0) return crc;
+	return ~crc32(~crc, src, (uint)len);
+}
+
+emType_Bits32 emType_GetCrc32CNextFn(emType_Bits32 crc, byte* src, int len)
+{
+	static const emType_CrcFnPtr crc32c = emType_Crc32CSelect();
+	if(len <= 0) return crc;
+	return ~crc32c(~crc, src, (uint)len);
+}
+
+#define	emType_GetCrc16NextExt(crc, src, off, len)	\
+	emType_GetCrc16NextFn((uint16)(crc), ((byte*)(src)) + (off), (int)(len))
+
+#define	emType_GetCrc16NextInt(crc, off, len)	\
+	emType_GetCrc16NextExt(crc, &emType, off, len)
+
+#define	emType_GetCrc16Next(...)	\
+	Macro(Macro4(__VA_ARGS__, emType_GetCrc16NextExt, emType_GetCrc16NextInt)(__VA_ARGS__))
+
+#define	emType_GetCrc16Ext(src, off, len)	\
+	emType_GetCrc16NextExt(0, src, off, len)
+
+#define	emType_GetCrc16Int(off, len)	\
+	emType_GetCrc16Ext(&emType, off, len)
+
+#define	emType_GetCrc16(...)	\
+	Macro(Macro3(__VA_ARGS__, emType_GetCrc16Ext, emType_GetCrc16Int)(__VA_ARGS__))
+
+#define	emType_GetCrc32NextExt(crc, src, off, len)	\
+	emType_GetCrc32NextFn((emType_Bits32)(crc), ((byte*)(src)) + (off), (int)(len))
+
+#define	emType_GetCrc32NextInt(crc, off, len)	\
+	emType_GetCrc32NextExt(crc, &emType, off, len)
+
+#define	emType_GetCrc32Next(...)	\
+	Macro(Macro4(__VA_ARGS__, emType_GetCrc32NextExt, emType_GetCrc32NextInt)(__VA_ARGS__))
+
+#define	emType_GetCrc32Ext(src, off, len)	\
+	emType_GetCrc32NextExt(0, src, off, len)
+
+#define	emType_GetCrc32Int(off, len)	\
+	emType_GetCrc32Ext(&emType, off, len)
+
+#define	emType_GetCrc32(...)	\
+	Macro(Macro3(__VA_ARGS__, emType_GetCrc32Ext, emType_GetCrc32Int)(__VA_ARGS__))
+
+#define	emType_GetCrc32CNextExt(crc, src, off, len)	\
+	emType_GetCrc32CNextFn((emType_Bits32)(crc), ((byte*)(src)) + (off), (int)(len))
+
+#define	emType_GetCrc32CNextInt(crc, off, len)	\
+	emType_GetCrc32CNextExt(crc, &emType, off, len)
+
+#define	emType_GetCrc32CNext(...)	\
+	Macro(Macro4(__VA_ARGS__, emType_GetCrc32CNextExt, emType_GetCrc32CNextInt)(__VA_ARGS__))
+
+#define	emType_GetCrc32CExt(src, off, len)	\
+	emType_GetCrc32CNextExt(0, src, off, len)
+
+#define	emType_GetCrc32CInt(off, len)	\
+	emType_GetCrc32CExt(&emType, off, len)
+
+#define	emType_GetCrc32C(...)	\
+	Macro(Macro3(__VA_ARGS__, emType_GetCrc32CExt, emType_GetCrc32CInt)(__VA_ARGS__))
+
+#if emType_Shorthand >= 1
+#define	type_GetCrc16			emType_GetCrc16
+#define	type_GetCrc32			emType_GetCrc32
+#define	type_GetCrc32C			emType_GetCrc32C
+#define	type_GetCrc16Next		emType_GetCrc16Next
+#define	type_GetCrc32Next		emType_GetCrc32Next
+#define	type_GetCrc32CNext		emType_GetCrc32CNext
+#endif
+
+#if	emType_Shorthand >= 2
+#define	typGetCrc16				emType_GetCrc16
+#define	typGetCrc32				emType_GetCrc32
+#define	typGetCrc32C			emType_GetCrc32C
+#define	typGetCrc16Next			emType_GetCrc16Next
+#define	typGetCrc32Next			emType_GetCrc32Next
+#define	typGetCrc32CNext		emType_GetCrc32CNext
+#endif
+
+#if	emType_Shorthand >= 3
+#define	GetCrc16				emType_GetCrc16
+#define	GetCrc32				emType_GetCrc32
+#define	GetCrc32C				emType_GetCrc32C
+#define	GetCrc16Next			emType_GetCrc16Next
+#define	GetCrc32Next			emType_GetCrc32Next
+#define	GetCrc32CNext			emType_GetCrc32CNext
+#endif
+
+
+
+// Function:
+// GetHexFromBin(*dst, sz, *src, off, len, opt)
+// GetHexFromBin(*dst, sz, off, len, opt)
+// 
+// Get hexadecimal string (dst) of maximum specified size (sz) of
+// the soure binary data (src + off) of specified length (len). The
+// options (opt) specify how the conversion is to be performed, and
+// it takes as input a set of flags. If source base address is not
+// specified, this library's internal buffer is assumed as the source
+// base address. The number of bytes that fit in the string is found
+// upfront, and without spaces or chars, each byte is converted with
+// a pair lookup table, or 16 bytes at a time on PC (SSSE3).
+// 
+// Parameters:
+// dst:	      the destination string where hex string will be stored
+// sz:        the maximum possible size of the hex string (buffer size)
+// src:	      the base address of source binary data
+// off:	      offset to the binary data to be converted (src + off)
+// len:	      length of data to be converted
+// opt:	      conversion options (TYPE_ADD_SPACE, TYPE_ADD_CHAR, TYPE_BIG_ENDIAN)
+// 
+// Returns:
+// nothing
+// 
+#define emType_HEX_TO_BIN(ch)		emType_HexValue[(byte)(ch)]
+
+#define emType_BIN_TO_HEX(bn)		(((bn) <= 9)? (bn)+'0' : (bn)+'7' )
+
+#define	emType_NO_SPACE				0
+
+#define emType_ADD_SPACE			1
+
+#define	emType_HAS_SPACE			1
+
+#define	emType_NO_CHAR				0
+
+#define emType_ADD_CHAR				2
+
+#define	emType_HAS_CHAR				2
+
+#define	emType_LITTLE_ENDIAN		0
+
+#define emType_BIG_ENDIAN			4
+
+static const char emType_HexPair[] =
+	"000102030405060708090A0B0C0D0E0F"
+	"101112131415161718191A1B1C1D1E1F"
+	"202122232425262728292A2B2C2D2E2F"
+	"303132333435363738393A3B3C3D3E3F"
+	"404142434445464748494A4B4C4D4E4F"
+	"505152535455565758595A5B5C5D5E5F"
+	"606162636465666768696A6B6C6D6E6F"
+	"707172737475767778797A7B7C7D7E7F"
+	"808182838485868788898A8B8C8D8E8F"
+	"909192939495969798999A9B9C9D9E9F"
+	"A0A1A2A3A4A5A6A7A8A9AAABACADAEAF"
+	"B0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+	"C0C1C2C3C4C5C6C7C8C9CACBCCCDCECF"
+	"D0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+	"E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEF"
+	"F0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+
+typedef void (*emType_GetHexFnPtr)(string dst, byte* src, uint len, int stp);
+
+static void emType_GetHexScalar(string dst, byte* src, uint len, int stp)
+{
+	for(; len>0; len--, src+=stp, dst+=2)
+	{ memcpy(dst, emType_HexPair + (*src << 1), 2); }
+}
+
+#if defined(emType_Dispatch) || defined(emType_SSSE3)
+emType_TargetSsse3 static void emType_GetHexSsse3(string dst, byte* src, uint len, int stp)
+{
+	__m128i dig = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F');
+	__m128i rev = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+	__m128i low = _mm_set1_epi8(0x0F), v, hi, lo;
+	for(; len >= 16; len -= 16, src += 16 * stp, dst += 32)
+	{
+		if(stp > 0) v = _mm_loadu_si128((__m128i*)src);
+		else v = _mm_shuffle_epi8(_mm_loadu_si128((__m128i*)(src - 15)), rev);
+		hi = _mm_shuffle_epi8(dig, _mm_and_si128(_mm_srli_epi16(v, 4), low));
+		lo = _mm_shuffle_epi8(dig, _mm_and_si128(v, low));
+		_mm_storeu_si128((__m128i*)dst, _mm_unpacklo_epi8(hi, lo));
+		_mm_storeu_si128((__m128i*)(dst + 16), _mm_unpackhi_epi8(hi, lo));
+	}
+	emType_GetHexScalar(dst, src, len, stp);
+}
+#endif
+
+#if defined(emType_Dispatch)
+static emType_GetHexFnPtr emType_GetHexSelect(void)
+{
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("ssse3")) return emType_GetHexSsse3;
+	return emType_GetHexScalar;
+}
+#elif defined(emType_SSSE3)
+#define	emType_GetHexSelect()	emType_GetHexSsse3
+#else
+#define	emType_GetHexSelect()	emType_GetHexScalar
+#endif
+
+string emType_GetHexFromBinExtFn(string dst, int sz, byte* src, int off, int len, byte opt)
+{
+	static const emType_GetHexFnPtr hex = emType_GetHexSelect();
+	char ent[4];
+	int wid = 2 + ((opt & emType_ADD_CHAR)? 1 : 0) + ((opt & emType_ADD_SPACE)? 1 : 0);
+	int i, cnt, stp = (opt & emType_BIG_ENDIAN)? 1 : -1;
+	if(sz < 1) return dst;
+	if(len < 0) len = 0;
+	src += off + ((opt & emType_BIG_ENDIAN)? 0 : (len - 1));
+	cnt = (sz - 1) / wid;
+	if(cnt > len) cnt = len;
+	if(wid == 2)
+	{
+		hex(dst, src, (uint)cnt, stp);
+		dst += cnt << 1;
+		src += cnt * stp;
+	}
+	else for(i=0; i<cnt; i++, src+=stp)
+	{
+		memcpy(dst, emType_HexPair + (*src << 1), 2); dst += 2;
+		if(opt & emType_ADD_CHAR) { *dst = (*src < 32 || *src > 127)? '.' : *src; dst++; }
+		if(opt & emType_ADD_SPACE) { *dst = ' '; dst++; }
+	}
+	if(cnt < len && (i = (sz - 1) - cnt * wid) > 0)
+	{
+		memcpy(ent, emType_HexPair + (*src << 1), 2);
+		ent[2] = (opt & emType_ADD_CHAR)? ((*src < 32 || *src > 127)? '.' : *src) : ' ';
+		ent[3] = ' ';
+		memcpy(dst, ent, i);
+		dst += i;
+	}
+	*dst = '\0';
+	return dst;
+}
+
+#define	emType_GetHexFromBinExt(dst, sz, src, off, len, opt)	\
+	emType_GetHexFromBinExtFn((string)(dst), (int)(sz), (byte*)(src), (int)(off), (int)(len), (byte)(opt))
+
+#define	emType_GetHexFromBinInt(dst, sz, off, len, opt)	\
+	emType_GetHexFromBinExt(dst, sz, &emType, off, len, opt)
+
+#define	emType_GetHexFromBin(...)	\
+	Macro(Macro6(__VA_ARGS__, emType_GetHexFromBinExt, emType_GetHexFromBinInt)(__VA_ARGS__))
+
+#if emType_Shorthand >= 1
+#define	type_HEX_TO_BIN			emType_HEX_TO_BIN
+#define	type_BIN_TO_HEX			emType_BIN_TO_HEX
+#define	type_NO_SPACE			emType_NO_SPACE
+#define	type_ADD_SPACE			emType_ADD_SPACE
+#define	type_HAS_SPACE			emType_HAS_SPACE
+#define	type_NO_CHAR			emType_NO_CHAR
+#define	type_ADD_CHAR			emType_ADD_CHAR
+#define	type_HAS_CHAR			emType_HAS_CHAR
+#define	type_LITTLE_ENDIAN		emType_LITTLE_ENDIAN
+#define	type_BIG_ENDIAN			emType_BIG_ENDIAN
+#define	type_GetHexFromBin		emType_GetHexFromBin
+#endif
+
+#if	emType_Shorthand >= 2
+#define	typHEX_TO_BIN			emType_HEX_TO_BIN
+#define	typBIN_TO_HEX			emType_BIN_TO_HEX
+#define	typNO_SPACE				emType_NO_SPACE
+#define	typADD_SPACE			emType_ADD_SPACE
+#define	typHAS_SPACE			emType_HAS_SPACE
+#define	typNO_CHAR				emType_NO_CHAR
 #define	typADD_CHAR				emType_ADD_CHAR
 #define	typHAS_CHAR				emType_HAS_CHAR
 #define	typLITTLE_ENDIAN		emType_LITTLE_ENDIAN
@@ -1440,6 +4053,9 @@ string emType_GetHexFromBinExtFn(string dst, int sz, byte* src, int off, int len
 #define	NO_CHAR					emType_NO_CHAR
 #define	ADD_CHAR				emType_ADD_CHAR
 #define	HAS_CHAR				emType_HAS_CHAR
+// the system LITTLE_ENDIAN / BIG_ENDIAN (<endian.h>) are byte orders, not options
+#undef	LITTLE_ENDIAN
+#undef	BIG_ENDIAN
 #define	LITTLE_ENDIAN			emType_LITTLE_ENDIAN
 #define	BIG_ENDIAN				emType_BIG_ENDIAN
 #define	GetHexFromBin			emType_GetHexFromBin
@@ -1450,39 +4066,148 @@ string emType_GetHexFromBinExtFn(string dst, int sz, byte* src, int off, int len
 // Function:
 // PutBinFromHex(*dst, off, len, *src, opt)
 // PutBinFromHex(off, len, *src, opt)
+// PutBinFromHexLen(*dst, off, len, *src, slen, opt)
+// PutBinFromHexLen(off, len, *src, slen, opt)
 // 
 // Puts binary data from the source hex string (src) to the destination
 // address (dst + off) of specified length len. The options (opt) specify
 // how the conversion is to be performed, and it takes as input a set of
 // flags. If destination base address is not specified, this library's
-// internal buffer is assumed as the destination base address.
+// internal buffer is assumed as the destination base address. Both upper
+// and lower case hex digits are accepted, and any other character (apart
+// from the skipped space / char) is reported as invalid. If the length of
+// the hex string (slen) is already known, it can be passed to avoid a
+// strlen. Without spaces or chars, 32 hex digits are decoded at a time on
+// PC (SSSE3).
 // 
 // Parameters:
 // dst:	      the base address of destination
 // off:	      the destination offset where the binary data will be stored (dst + off)
 // len:       length of data at destination
 // src:	      the hex string to be converted
+// slen:      length of the hex string
 // opt:	      conversion options (TYPE_HAS_SPACE, TYPE_HAS_CHAR, TYPE_BIG_ENDIAN)
 //
 // Returns:
-// the converted data (dst)
+// status:	0 for success, 0xFF for invalid hex digit
 // 
-void emType_PutBinFromHexExtFn(byte* dst, int off, int len, string src, byte opt)
+static const byte emType_HexValue[] =
+{
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+typedef byte (*emType_PutBinFnPtr)(byte* dst, byte* src, uint cnt, byte rev);
+
+static byte emType_PutBinScalar(byte* dst, byte* src, uint cnt, byte rev)
+{
+	byte hi, lo, bad = 0;
+	int stp = rev? -1 : 1;
+	if(rev) dst += cnt - 1;
+	for(; cnt>0; cnt--, src+=2, dst+=stp)
+	{
+		hi = emType_HexValue[src[0]];
+		lo = emType_HexValue[src[1]];
+		bad |= hi | lo;
+		*dst = (byte)((hi << 4) | lo);
+	}
+	return (bad & 0xF0)? 0xFF : 0;
+}
+
+#if defined(emType_Dispatch) || defined(emType_SSSE3)
+emType_TargetSsse3 static byte emType_PutBinSsse3(byte* dst, byte* src, uint cnt, byte rev)
 {
-	char* psrc = src + strlen(src) - 1;
+	uint i = 0, k;
+	__m128i zro = _mm_set1_epi8('0'), alf = _mm_set1_epi8('a'), lcs = _mm_set1_epi8(0x20);
+	__m128i nin = _mm_set1_epi8(9), fiv = _mm_set1_epi8(5), ten = _mm_set1_epi8(10);
+	__m128i wgt = _mm_set1_epi16(0x0110), one = _mm_set1_epi8(-1), bad = _mm_setzero_si128();
+	__m128i rvm = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+	__m128i c, d, l, dv, lv, n[2], out;
+	for(; i + 16 <= cnt; i += 16, src += 32)
+	{
+		for(k=0; k<2; k++)
+		{
+			c = _mm_loadu_si128((__m128i*)(src + 16 * k));
+			d = _mm_sub_epi8(c, zro);
+			l = _mm_sub_epi8(_mm_or_si128(c, lcs), alf);
+			dv = _mm_cmpeq_epi8(_mm_min_epu8(d, nin), d);
+			lv = _mm_cmpeq_epi8(_mm_min_epu8(l, fiv), l);
+			bad = _mm_or_si128(bad, _mm_andnot_si128(_mm_or_si128(dv, lv), one));
+			n[k] = _mm_or_si128(_mm_and_si128(dv, d), _mm_and_si128(lv, _mm_add_epi8(l, ten)));
+		}
+		out = _mm_packus_epi16(_mm_maddubs_epi16(n[0], wgt), _mm_maddubs_epi16(n[1], wgt));
+		if(rev) _mm_storeu_si128((__m128i*)(dst + cnt - i - 16), _mm_shuffle_epi8(out, rvm));
+		else _mm_storeu_si128((__m128i*)(dst + i), out);
+	}
+	return (_mm_movemask_epi8(bad)? 0xFF : 0) | emType_PutBinScalar(rev? dst : dst + i, src, cnt - i, rev);
+}
+#endif
+
+#if defined(emType_Dispatch)
+static emType_PutBinFnPtr emType_PutBinSelect(void)
+{
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("ssse3")) return emType_PutBinSsse3;
+	return emType_PutBinScalar;
+}
+#elif defined(emType_SSSE3)
+#define	emType_PutBinSelect()	emType_PutBinSsse3
+#else
+#define	emType_PutBinSelect()	emType_PutBinScalar
+#endif
+
+byte emType_PutBinFromHexLenFn(byte* dst, int off, int len, string src, int slen, byte opt)
+{
+	static const emType_PutBinFnPtr bin = emType_PutBinSelect();
+	byte hi, lo, bad = 0, *psrc = (byte*)src + slen - 1;
+	int i = 0, cnt, stp = (opt & emType_BIG_ENDIAN)? -1 : 1;
 	dst += off + ((opt & emType_BIG_ENDIAN)? (len - 1) : 0);
-	int i ,stp = (opt & emType_BIG_ENDIAN)? -1 : 1;
-	for(i=0; i<len; i++, dst+=stp)
+	if(!(opt & (emType_HAS_SPACE | emType_HAS_CHAR)))
+	{
+		cnt = slen >> 1;
+		if(cnt > len) cnt = len;
+		if(cnt > 0) bad = bin((stp > 0)? dst : dst - (cnt - 1), psrc + 1 - 2 * cnt, (uint)cnt, (byte)(stp > 0));
+		i = cnt;
+		dst += cnt * stp;
+		psrc -= 2 * cnt;
+	}
+	for(; i<len; i++, dst+=stp)
 	{
 		if(opt & emType_HAS_SPACE) psrc--;
 		if(opt & emType_HAS_CHAR) psrc--;
-		*dst = (psrc < src)? 0 : emType_HEX_TO_BIN(*psrc); psrc--;
-		*dst |= (psrc < src)? 0 : emType_HEX_TO_BIN(*psrc) << 4; psrc--;
+		lo = (psrc < (byte*)src)? 0 : emType_HexValue[*psrc]; psrc--;
+		hi = (psrc < (byte*)src)? 0 : emType_HexValue[*psrc]; psrc--;
+		bad |= hi | lo;
+		*dst = (byte)((hi << 4) | lo);
 	}
+	return (bad & 0xF0)? 0xFF : 0;
 }
 
+#define	emType_PutBinFromHexLenExt(dst, off, len, src, slen, opt)	\
+	emType_PutBinFromHexLenFn((byte*)(dst), (int)(off), (int)(len), (string)(src), (int)(slen), (byte)(opt))
+
+#define	emType_PutBinFromHexLenInt(off, len, src, slen, opt)	\
+	emType_PutBinFromHexLenExt(&emType, off, len, src, slen, opt)
+
+#define	emType_PutBinFromHexLen(...)	\
+	Macro(Macro6(__VA_ARGS__, emType_PutBinFromHexLenExt, emType_PutBinFromHexLenInt)(__VA_ARGS__))
+
 #define	emType_PutBinFromHexExt(dst, off, len, src, opt)	\
-	emType_PutBinFromHexExtFn((byte*)(dst), (int)(off), (int)(len), (string)(src), (byte)(opt))
+	emType_PutBinFromHexLenExt(dst, off, len, src, strlen((string)(src)), opt)
 
 #define	emType_PutBinFromHexInt(off, len, src, opt)	\
 	emType_PutBinFromHexExt(&emType, off, len, src, opt)
@@ -1492,14 +4217,17 @@ void emType_PutBinFromHexExtFn(byte* dst, int off, int len, string src, byte opt
 
 #if emType_Shorthand >= 1
 #define	type_PutBinFromHex		emType_PutBinFromHex
+#define	type_PutBinFromHexLen	emType_PutBinFromHexLen
 #endif
 
 #if	emType_Shorthand >= 2
 #define	typPutBinFromHex		emType_PutBinFromHex
+#define	typPutBinFromHexLen		emType_PutBinFromHexLen
 #endif
 
 #if	emType_Shorthand >= 3
 #define	PutBinFromHex			emType_PutBinFromHex
+#define	PutBinFromHexLen		emType_PutBinFromHexLen
 #endif
 
 
@@ -0,0 +1,133 @@
+/*
+----------------------------------------------------------------------------------------
+	emType: Check values test (PC)
+	File: lib_Type_Test.cpp
+
+    This file is part of emType. For more details, go through
+	Readme.txt. For copyright information, go through copyright.txt.
+
+    emType is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    emType is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with emType.  If not, see <http://www.gnu.org/licenses/>.
+----------------------------------------------------------------------------------------
+*/
+
+
+
+/*
+	Checks the results of emType functions against known values, and against
+	other ways of computing the same result (such as a checksum computed chunk
+	by chunk, against one computed over the whole data). Prints each failed
+	check, and returns the number of failed checks. Build with a C++11
+	compiler, e.g- g++ -O2 -I../lib_Type_CPP lib_Type_Test.cpp
+*/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "embd.h"
+
+
+
+#define	Test_Frame			1500
+
+
+
+byte	Frame[Test_Frame];
+uint	Fails;
+
+
+
+void TestCheck(int ok, const char* name, uint arg)
+{
+	if(ok) return;
+	printf("FAIL: %s (%u)\n", name, arg);
+	Fails++;
+}
+
+
+
+// a frame summed chunk by chunk gives the same sum as the whole frame
+void TestSumNext()
+{
+	uint len, pos, part;
+	ushort sum;
+	byte bsum;
+	for(len=0; len<=64; len++)
+	{
+		for(pos=0, sum=0, bsum=0; pos<len; pos += part)
+		{
+			part = (uint)rand() % 7 + 1;
+			if(part > len - pos) part = len - pos;
+			sum = emType_GetUshortSumNext(sum, pos, Frame, pos, part);
+			bsum = emType_GetByteSumNext(bsum, Frame, pos, part);
+		}
+		TestCheck(sum == emType_GetUshortSum(Frame, 0, len), "GetUshortSumNext", len);
+		TestCheck(bsum == emType_GetByteSum(Frame, 0, len), "GetByteSumNext", len);
+	}
+	for(pos=0, sum=0; pos<Test_Frame; pos += part)
+	{
+		part = (uint)rand() % 97 + 1;
+		if(part > Test_Frame - pos) part = Test_Frame - pos;
+		sum = emType_GetUshortSumNext(sum, pos, Frame, pos, part);
+	}
+	TestCheck(sum == emType_GetUshortSum(Frame, 0, Test_Frame), "GetUshortSumNext", Test_Frame);
+	// a trailing odd byte is summed padded with zero
+	TestCheck(emType_GetUshortSum(Frame, 0, 3) == (ushort)(emType_LoadBits16(Frame) + emType_SumLowByte(Frame[2])), "GetUshortSum odd", 3);
+}
+
+
+
+// standard check values (CRC of "123456789"), and CRCs computed chunk by chunk
+void TestCrc()
+{
+	byte check[] = "123456789";
+	uint len, pos, part;
+	uint16 crc16;
+	emType_Bits32 crc32, crc32c;
+	TestCheck(emType_GetCrc16(check, 0, 9) == 0x906E, "GetCrc16 check", 9);
+	TestCheck(emType_GetCrc32(check, 0, 9) == 0xCBF43926, "GetCrc32 check", 9);
+	TestCheck(emType_GetCrc32C(check, 0, 9) == 0xE3069283, "GetCrc32C check", 9);
+	for(len=0; len<=Test_Frame; len += (len < 300)? 1 : 97)
+	{
+		for(pos=0, crc16=0, crc32=0, crc32c=0; pos<len; pos += part)
+		{
+			part = (uint)rand() % 150 + 1;
+			if(part > len - pos) part = len - pos;
+			crc16 = emType_GetCrc16Next(crc16, Frame, pos, part);
+			crc32 = emType_GetCrc32Next(crc32, Frame, pos, part);
+			crc32c = emType_GetCrc32CNext(crc32c, Frame, pos, part);
+		}
+		TestCheck(crc16 == emType_GetCrc16(Frame, 0, len), "GetCrc16Next", len);
+		TestCheck(crc32 == emType_GetCrc32(Frame, 0, len), "GetCrc32Next", len);
+		TestCheck(crc32c == emType_GetCrc32C(Frame, 0, len), "GetCrc32CNext", len);
+#if embd_Platform == embd_PlatformPC
+		// the kernel selected at run time gives the same CRC as the tables
+		TestCheck(crc32 == (emType_Bits32)~emType_Crc32Slice(0xFFFFFFFF, Frame, len), "GetCrc32 kernel", len);
+		TestCheck(crc32c == (emType_Bits32)~emType_Crc32CSlice(0xFFFFFFFF, Frame, len), "GetCrc32C kernel", len);
+#endif
+	}
+}
+
+
+
+int main()
+{
+	uint i;
+	for(i=0; i<Test_Frame; i++)
+		Frame[i] = (byte)rand();
+	TestSumNext();
+	TestCrc();
+	printf("%u checks failed\n", Fails);
+	return (int)Fails;
+}